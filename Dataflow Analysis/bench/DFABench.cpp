@@ -0,0 +1,335 @@
+/// Scaling benchmark of the dataflow analyses over synthetic functions, e.g.,
+///
+///     dfa-bench -blocks=256,1024,4096 -depth=1,3 -irreducible=0,0.1
+///
+/// Every combination of the parameters is generated once, then each analysis
+/// is solved over it in a child process, so that the peak RSS is that of a
+/// single analysis (on top of the generated IR). One CSV row is printed per
+/// analysis and combination.
+///
+/// The heap allocations of the process are counted, so that the steady state
+/// of the solver (an iteration over a solution that is a fixpoint already) can
+/// be checked to allocate nothing.
+
+#include "DFA.h"
+
+#include <llvm/IR/Dominators.h>
+#include <llvm/IR/IRBuilder.h>
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/IR/Module.h>
+#include <llvm/IR/Verifier.h>
+#include <llvm/Support/CommandLine.h>
+#include <llvm/Transforms/Utils/PromoteMemToReg.h>
+
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <random>
+
+using namespace llvm;
+
+static std::atomic<size_t> NumAllocs{0};
+
+#ifdef __GLIBC__
+// interpose the C allocator, which both operator new and the LLVM containers
+// end up in
+extern "C" {
+void *__libc_malloc(size_t);
+void *__libc_calloc(size_t, size_t);
+void *__libc_realloc(void *, size_t);
+
+void *malloc(size_t Size) {
+  NumAllocs.fetch_add(1, std::memory_order_relaxed);
+  return __libc_malloc(Size);
+}
+void *calloc(size_t Num, size_t Size) {
+  NumAllocs.fetch_add(1, std::memory_order_relaxed);
+  return __libc_calloc(Num, Size);
+}
+void *realloc(void *Ptr, size_t Size) {
+  NumAllocs.fetch_add(1, std::memory_order_relaxed);
+  return __libc_realloc(Ptr, Size);
+}
+}
+#endif
+
+static cl::list<unsigned> BlockCounts("blocks", cl::CommaSeparated,
+                                      cl::desc("Numbers of basic blocks"));
+static cl::list<unsigned>
+    ExprCounts("exprs", cl::CommaSeparated,
+               cl::desc("Numbers of binary expressions (default: 4 per block)"));
+static cl::list<unsigned> Depths("depth", cl::CommaSeparated,
+                                 cl::desc("Loop nesting depths"));
+static cl::list<double>
+    IrreducibleRatios("irreducible", cl::CommaSeparated,
+                      cl::desc("Probabilities that a forward branch enters a "
+                               "loop other than through its header"));
+static cl::list<std::string>
+    AnalysisNames("analyses", cl::CommaSeparated,
+                  cl::desc("Analyses to run (default: all)"));
+static cl::opt<unsigned> Seed("seed", cl::init(1),
+                              cl::desc("Seed of the generator"));
+static cl::opt<unsigned>
+    Repeat("repeat", cl::init(3),
+           cl::desc("Number of solves, of which the fastest is reported"));
+static cl::opt<bool>
+    ShuffleSuccs("shuffle-succs",
+                 cl::desc("Put the successors of the conditional branches in "
+                          "random order, rather than the fall-through first"));
+static cl::opt<bool> Sparse("sparse",
+                            cl::desc("Use the sparse engines of the analyses"));
+
+namespace {
+
+struct CFGParams {
+  unsigned Blocks, Exprs, Depth;
+  double Irreducible;
+};
+
+/// @brief Generate @c bench(a, b) over a few stack variables, which are then
+///        promoted to SSA values. The blocks are laid out in a chain, where
+///        the loops are nested ranges of blocks closed by a back edge from
+///        their last block, and the other blocks may branch forward.
+class CFGGenerator {
+  const CFGParams &Params;
+  std::mt19937 Rand;
+  /// First and last block of each loop, outermost first.
+  std::vector<std::pair<unsigned, unsigned>> Loops;
+
+  static constexpr unsigned NumVars = 8;
+
+  unsigned uniform(const unsigned Lo, const unsigned Hi) {
+    return std::uniform_int_distribution<unsigned>(Lo, Hi)(Rand);
+  }
+  bool coin(const double Probability) {
+    return std::bernoulli_distribution(Probability)(Rand);
+  }
+
+  bool inLoop(const unsigned Loop, const unsigned BB) const {
+    return Loops[Loop].first <= BB && BB <= Loops[Loop].second;
+  }
+
+  /// @brief Whether the edge @p From -> @p To enters a loop elsewhere than
+  ///        at its header.
+  bool isIrreducible(const unsigned From, const unsigned To) const {
+    for (unsigned Loop = 0; Loop < Loops.size(); ++Loop) {
+      if (inLoop(Loop, To) && !inLoop(Loop, From) &&
+          Loops[Loop].first != To) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+public:
+  CFGGenerator(const CFGParams &Params, const unsigned Seed)
+      : Params(Params), Rand(Seed) {
+    const unsigned Span =
+        std::max(1U, Params.Blocks / (2 * (Params.Depth + 1)));
+    for (unsigned Loop = 0; Loop < Params.Depth; ++Loop) {
+      const unsigned Header = Loop * Span,
+                     Latch = Params.Blocks - 1 - Loop * Span;
+      if (Header >= Latch) {
+        break;
+      }
+      Loops.emplace_back(Header, Latch);
+    }
+  }
+
+  Function *generate(Module &M) {
+    LLVMContext &Ctx = M.getContext();
+    Type *Int32Ty = Type::getInt32Ty(Ctx);
+    Function *F = Function::Create(
+        FunctionType::get(Int32Ty, {Int32Ty, Int32Ty}, false),
+        Function::ExternalLinkage, "bench", M);
+    BasicBlock *Entry = BasicBlock::Create(Ctx, "entry", F);
+    std::vector<BasicBlock *> BBs;
+    for (unsigned Idx = 0; Idx < Params.Blocks; ++Idx) {
+      BBs.push_back(BasicBlock::Create(Ctx, "b" + Twine(Idx), F));
+    }
+    BasicBlock *Exit = BasicBlock::Create(Ctx, "exit", F);
+
+    // half of the variables start as constants, the others as arguments
+    IRBuilder<> Builder(Entry);
+    std::vector<AllocaInst *> Vars;
+    for (unsigned Var = 0; Var < NumVars; ++Var) {
+      Vars.push_back(Builder.CreateAlloca(Int32Ty));
+      Builder.CreateStore(Var % 2 == 0 ? static_cast<Value *>(
+                                             Builder.getInt32(Var))
+                                       : F->getArg(Var % 4 / 2),
+                          Vars.back());
+    }
+    Builder.CreateBr(BBs.front());
+
+    auto loadVar = [&]() {
+      return Builder.CreateLoad(Int32Ty, Vars[uniform(0, NumVars - 1)]);
+    };
+    const Instruction::BinaryOps Opcodes[] = {
+        Instruction::Add, Instruction::Sub, Instruction::Mul, Instruction::Xor,
+        Instruction::And};
+    Instruction::BinaryOps Opcode = Instruction::Add;
+    Value *LHS = nullptr, *RHS = nullptr;
+    for (unsigned Idx = 0; Idx < Params.Blocks; ++Idx) {
+      Builder.SetInsertPoint(BBs[Idx]);
+      const unsigned NumExprs = Params.Exprs / Params.Blocks +
+                                (Idx < Params.Exprs % Params.Blocks ? 1 : 0);
+      for (unsigned Expr = 0; Expr < NumExprs; ++Expr) {
+        // repeat the previous expression at times, for redundancies
+        if (LHS == nullptr || !coin(0.3) ||
+            cast<Instruction>(LHS)->getParent() != BBs[Idx]) {
+          Opcode = Opcodes[uniform(0, std::size(Opcodes) - 1)];
+          LHS = loadVar();
+          RHS = coin(0.2) ? static_cast<Value *>(Builder.getInt32(uniform(1, 16)))
+                          : loadVar();
+        }
+        Builder.CreateStore(Builder.CreateBinOp(Opcode, LHS, RHS),
+                            Vars[uniform(0, NumVars - 1)]);
+      }
+
+      BasicBlock *Next = Idx + 1 < Params.Blocks ? BBs[Idx + 1] : Exit;
+      auto condBr = [&](BasicBlock *True, BasicBlock *False) {
+        Value *Cond =
+            Builder.CreateICmpSLT(loadVar(), Builder.getInt32(uniform(0, 16)));
+        if (ShuffleSuccs && coin(0.5)) {
+          std::swap(True, False);
+        }
+        Builder.CreateCondBr(Cond, True, False);
+      };
+      const auto LatchIt = llvm::find_if(Loops, [Idx](const auto &Loop) {
+        return Loop.second == Idx;
+      });
+      if (LatchIt != Loops.end()) {
+        condBr(BBs[LatchIt->first], Next);
+        continue;
+      }
+      if (Idx + 2 < Params.Blocks && coin(0.5)) {
+        const unsigned Target = uniform(Idx + 2, Params.Blocks - 1);
+        if (!isIrreducible(Idx, Target) || coin(Params.Irreducible)) {
+          condBr(Next, BBs[Target]);
+          continue;
+        }
+      }
+      Builder.CreateBr(Next);
+    }
+    Builder.SetInsertPoint(Exit);
+    Builder.CreateRet(Builder.CreateLoad(Int32Ty, Vars.front()));
+
+    DominatorTree DT(*F);
+    PromoteMemToReg(Vars, DT);
+    return F;
+  }
+};
+
+/// @brief Solve @c TAnalysis over @p F , and print the fastest of the runs,
+///        the counters, the peak RSS of the process and the allocations of a
+///        re-iteration over the solution (empty if there is none).
+template <typename TAnalysis>
+void benchAnalysis(Function &F, const StringRef Name, const CFGParams &Params) {
+  dfa::Options Opts;
+  Opts.Sparse = Sparse;
+  double BestMs = std::numeric_limits<double>::max();
+  size_t BlockVisits = 0, TransferCalls = 0;
+  for (unsigned Run = 0; Run < std::max(1U, Repeat.getValue()); ++Run) {
+    TAnalysis Analysis(Opts);
+    const auto Start = std::chrono::steady_clock::now();
+    Analysis.solve(F);
+    BestMs = std::min(
+        BestMs, std::chrono::duration<double, std::milli>(
+                    std::chrono::steady_clock::now() - Start)
+                    .count());
+    BlockVisits = Analysis.getNumBlockVisits();
+    TransferCalls = Analysis.getNumTransferCalls();
+  }
+  // the first re-iteration builds the traversal of the CFG, unless the
+  // dense solver has done so already
+  TAnalysis Analysis(Opts);
+  Analysis.solve(F);
+  Analysis.reiterate(F);
+  const size_t AllocsBefore = NumAllocs.load();
+  const bool Reiterated = Analysis.reiterate(F);
+  const size_t SteadyAllocs = NumAllocs.load() - AllocsBefore;
+  rusage Usage{};
+  getrusage(RUSAGE_SELF, &Usage);
+  outs() << Name << "," << Params.Blocks << "," << Params.Exprs << ","
+         << Params.Depth << "," << format("%g", Params.Irreducible) << ","
+         << format("%.3f", BestMs) << "," << BlockVisits << ","
+         << TransferCalls << "," << Usage.ru_maxrss << ",";
+  if (Reiterated) {
+    outs() << SteadyAllocs;
+  }
+  outs() << "\n";
+}
+
+/// @brief Run @p Name over @p F in a child process.
+/// @return False if it has failed (e.g., been killed for running out of
+///         memory).
+bool forkAnalysis(Function &F, const std::string &Name,
+                  const CFGParams &Params) {
+  outs().flush();
+  const pid_t Child = fork();
+  if (Child == 0) {
+    if (Name == "avail-expr") {
+      benchAnalysis<AvailExprs>(F, Name, Params);
+    } else if (Name == "liveness") {
+      benchAnalysis<Liveness>(F, Name, Params);
+    } else {
+      benchAnalysis<SCCP>(F, Name, Params);
+    }
+    outs().flush();
+    _exit(0);
+  }
+  int Status = 0;
+  return Child > 0 && waitpid(Child, &Status, 0) == Child &&
+         WIFEXITED(Status) && WEXITSTATUS(Status) == 0;
+}
+
+template <typename T>
+std::vector<T> valuesOr(const cl::list<T> &List, std::vector<T> Default) {
+  return List.empty() ? Default : std::vector<T>(List.begin(), List.end());
+}
+
+} // anonymous namespace
+
+int main(int argc, char **argv) {
+  cl::ParseCommandLineOptions(argc, argv, "Dataflow analysis benchmark\n");
+  const std::vector<std::string> Names = valuesOr<std::string>(
+      AnalysisNames, {"avail-expr", "liveness", "const-prop"});
+  for (const std::string &Name : Names) {
+    if (Name != "avail-expr" && Name != "liveness" && Name != "const-prop") {
+      errs() << "Unknown analysis: " << Name << "\n";
+      return 1;
+    }
+  }
+
+  bool Failed = false;
+  outs() << "analysis,blocks,exprs,depth,irreducible,wall_ms,block_visits,"
+            "transfer_calls,peak_rss_kb,steady_allocs\n";
+  for (const unsigned Blocks : valuesOr<unsigned>(BlockCounts, {64, 256, 1024})) {
+    for (const unsigned Exprs : valuesOr<unsigned>(ExprCounts, {4 * Blocks})) {
+      for (const unsigned Depth : valuesOr<unsigned>(Depths, {2})) {
+        for (const double Irreducible :
+             valuesOr<double>(IrreducibleRatios, {0.0})) {
+          const CFGParams Params{std::max(1U, Blocks), Exprs, Depth,
+                                 Irreducible};
+          LLVMContext Ctx;
+          Module M("dfa-bench", Ctx);
+          Function *F = CFGGenerator(Params, Seed).generate(M);
+          if (verifyFunction(*F, &errs())) {
+            return 1;
+          }
+          for (const std::string &Name : Names) {
+            if (!forkAnalysis(*F, Name, Params)) {
+              errs() << "Failed to run " << Name << " over " << Blocks
+                     << " blocks\n";
+              Failed = true;
+            }
+          }
+        }
+      }
+    }
+  }
+  return Failed ? 1 : 0;
+}
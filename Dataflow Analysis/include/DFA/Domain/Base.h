@@ -1,29 +1,79 @@
-#pragma once // NOLINT(llvm-header-guard)
-
-#include <unordered_map>
-#include <vector>
-
-namespace dfa {
-
-template <typename TDerivedDomainElem> struct DomainBase {
-
-  virtual bool operator==(const TDerivedDomainElem &Other) const = 0;
-
-  /// @brief Check whether the domain element contains the given value.
-  /// @param Val
-  /// @return
-  virtual bool contain(const llvm::Value *const Val) const = 0;
-  /// @brief Replace all the occurrences of the source value with the
-  ///        destination value.
-  /// @param SrcVal
-  /// @param DstVal
-  /// @return
-  virtual TDerivedDomainElem
-  replaceValueWith(const llvm::Value *const SrcVal,
-                   const llvm::Value *const DstVal) const = 0;
-
-  using DomainIdMap_t = std::unordered_map<TDerivedDomainElem, size_t>;
-  using DomainVector_t = std::vector<TDerivedDomainElem>;
-};
-
-} // namespace dfa
+#pragma once // NOLINT(llvm-header-guard)
+
+#include <llvm/ADT/ArrayRef.h>
+#include <llvm/IR/Instruction.h>
+
+#include <unordered_map>
+#include <vector>
+
+namespace dfa {
+
+/// @brief Lists of domain ids per instruction, stored as spans of one flat
+///        array. It is built once per function, so that the transfer functions
+///        loop over plain integers rather than searching the domain.
+class InstDomainIdTable {
+private:
+  std::vector<unsigned> Ids;
+  std::unordered_map<const llvm::Instruction *, std::pair<size_t, size_t>>
+      Spans;
+
+public:
+  /// @brief Set the ids of @p Inst , which have to be given all at once. Ids
+  ///        set previously are replaced (though their storage is not freed
+  ///        until @c clear ).
+  void insert(const llvm::Instruction *const Inst,
+              llvm::ArrayRef<unsigned> InstIds) {
+    Spans[Inst] = {Ids.size(), InstIds.size()};
+    Ids.insert(Ids.end(), InstIds.begin(), InstIds.end());
+  }
+
+  /// @brief Get the ids of @p Inst , empty if none has been set.
+  llvm::ArrayRef<unsigned> lookup(const llvm::Instruction *const Inst) const {
+    auto SpanIt = Spans.find(Inst);
+    if (SpanIt == Spans.end()) {
+      return {};
+    }
+    return llvm::ArrayRef<unsigned>(Ids).slice(SpanIt->second.first,
+                                               SpanIt->second.second);
+  }
+
+  void clear() {
+    Ids.clear();
+    Spans.clear();
+  }
+};
+
+template <typename TDerivedDomainElem> struct DomainBase {
+
+  virtual bool operator==(const TDerivedDomainElem &Other) const = 0;
+
+  /// @brief Check whether the domain element contains the given value.
+  /// @param Val
+  /// @return
+  virtual bool contain(const llvm::Value *const Val) const = 0;
+  /// @brief Replace all the occurrences of the source value with the
+  ///        destination value.
+  /// @param SrcVal
+  /// @param DstVal
+  /// @return
+  virtual TDerivedDomainElem
+  replaceValueWith(const llvm::Value *const SrcVal,
+                   const llvm::Value *const DstVal) const = 0;
+
+  /// @brief Check whether the domain element reads memory, i.e., whether
+  ///        the instructions that write to memory may kill it (see
+  ///        @c mayBeClobberedBy ).
+  virtual bool readsMemory() const { return false; }
+  /// @brief Check whether @p Inst , which writes to memory, may change the
+  ///        memory that the domain element reads.
+  /// @param Inst
+  /// @return
+  virtual bool mayBeClobberedBy(const llvm::Instruction &Inst) const {
+    return false;
+  }
+
+  using DomainIdMap_t = std::unordered_map<TDerivedDomainElem, size_t>;
+  using DomainVector_t = std::vector<TDerivedDomainElem>;
+};
+
+} // namespace dfa
@@ -1,75 +1,139 @@
-#pragma once // NOLINT(llvm-header-guard)
-
-#include <llvm/IR/InstVisitor.h>
-#include <llvm/IR/Instruction.h>
-#include <llvm/IR/Instructions.h>
-#include <llvm/IR/Value.h>
-#include <llvm/Support/raw_ostream.h>
-#include "Base.h"
-#include "Utility.h"
-
-namespace dfa {
-
-    struct Expression final : DomainBase<Expression> {
-        const unsigned Opcode;
-        const llvm::Value *const LHS = nullptr, *const RHS = nullptr;
-        const bool Commutative;
-
-        Expression(const llvm::BinaryOperator &BinaryOp) : Opcode(BinaryOp.getOpcode()),
-                                                           LHS(BinaryOp.getOperand(0)),
-                                                           RHS(BinaryOp.getOperand(1)), Commutative(BinaryOp.isCommutative()) {}
-
-        Expression(const unsigned Opcode, const llvm::Value *const LHS,
-                   const llvm::Value *const RHS, const bool IsCommutative)
-                : Opcode(Opcode), LHS(LHS), RHS(RHS), Commutative(IsCommutative) {}
-
-        bool operator==(const Expression &Other) const final {
-            /// @todo(CSCD70) Please complete this method.
-            if (Commutative) {
-                return Other.Opcode == Opcode && ((LHS == Other.LHS && RHS == Other.RHS) || (LHS == Other.RHS && RHS == Other.LHS));
-            }
-            return Other.Opcode == Opcode && LHS == Other.LHS && RHS == Other.RHS;
-        }
-
-        bool contain(const llvm::Value *const Val) const final {
-            /// @todo(CSCD70) Please complete this method.
-            return LHS == Val || RHS == Val;
-        }
-
-        Expression replaceValueWith(const llvm::Value *const SrcVal,
-                                    const llvm::Value *const DstVal) const final {
-            /// @todo(CSCD70) Please complete this method.
-            return Expression(Opcode, LHS == SrcVal ? DstVal : LHS, RHS == SrcVal ? DstVal : RHS, Commutative);
-        }
-
-        //
-        using DomainBase<Expression>::DomainIdMap_t;
-
-        using DomainBase<Expression>::DomainVector_t;
-
-        struct Initializer : public llvm::InstVisitor<Initializer> {
-            DomainIdMap_t& DomainIdMap;
-            DomainVector_t& DomainVector;
-            explicit Initializer(DomainIdMap_t& DomainIdMap,
-                                 DomainVector_t& DomainVector)
-                    : DomainIdMap(DomainIdMap), DomainVector(DomainVector) {}
-            void visitBinaryOperator(llvm::BinaryOperator &);
-        };
-    };
-
-} // namespace dfa
-
-llvm::raw_ostream &operator<<(llvm::raw_ostream &, const dfa::Expression &);
-
-namespace std {
-
-    template<>
-    struct hash<::dfa::Expression> {
-        size_t operator()(const dfa::Expression &Expr) const {
-            size_t seed;
-            hashCombine(&seed, Expr.RHS, Expr.LHS, Expr.Opcode, Expr.Commutative);
-            return seed;
-        }
-    };
-
-} // namespace std
+#pragma once // NOLINT(llvm-header-guard)
+
+#include <llvm/ADT/STLExtras.h>
+#include <llvm/ADT/SmallVector.h>
+#include <llvm/IR/InstVisitor.h>
+#include <llvm/IR/Instruction.h>
+#include <llvm/IR/Instructions.h>
+#include <llvm/IR/Value.h>
+#include <llvm/Support/raw_ostream.h>
+#include "Base.h"
+#include "Utility.h"
+
+#include <algorithm>
+
+namespace dfa {
+
+    /// @brief A computation that only depends on its operands, i.e., a
+    ///        binary operator, a comparison, a cast, an address computation
+    ///        ( @c getelementptr ) or a simple load. Besides the operands, an
+    ///        expression is told apart by its opcode, the predicate of a
+    ///        comparison and the types that the operands alone do not
+    ///        determine (e.g., the destination type of a cast).
+    ///
+    ///        A load also depends on the memory it reads, which is versioned
+    ///        by the kills instead: the stores and calls that may write to it
+    ///        kill the expression (see @c mayBeClobberedBy ), so that it is
+    ///        only available as long as the memory is unchanged.
+    struct Expression final : DomainBase<Expression> {
+        const unsigned Opcode;
+        /// Predicate of a comparison, and zero otherwise.
+        const unsigned Predicate;
+        /// The type of the result, and the source element type of an address
+        /// computation (null otherwise).
+        const llvm::Type *const Type, *const SourceType;
+        const llvm::SmallVector<const llvm::Value *, 2> Operands;
+        /// Whether the two operands may be swapped (e.g., @c add , or
+        /// @c icmp @c eq ).
+        const bool Commutative;
+
+        /// @param Inst an instruction that evaluates an expression (see
+        ///             @c isExpression ).
+        explicit Expression(const llvm::Instruction &Inst);
+
+        Expression(const unsigned Opcode, const unsigned Predicate,
+                   const llvm::Type *const Type, const llvm::Type *const SourceType,
+                   llvm::ArrayRef<const llvm::Value *> Operands,
+                   const bool IsCommutative)
+                : Opcode(Opcode), Predicate(Predicate), Type(Type),
+                  SourceType(SourceType), Operands(Operands.begin(), Operands.end()),
+                  Commutative(IsCommutative) {}
+
+        /// @brief Check whether @p Inst evaluates an expression that the
+        ///        domain models. Loads only do if they are simple (i.e.,
+        ///        neither volatile nor atomic).
+        static bool isExpression(const llvm::Instruction &Inst);
+
+        bool operator==(const Expression &Other) const final {
+            if (Opcode != Other.Opcode || Predicate != Other.Predicate ||
+                Type != Other.Type || SourceType != Other.SourceType) {
+                return false;
+            }
+            if (Commutative) {
+                return (Operands[0] == Other.Operands[0] && Operands[1] == Other.Operands[1]) ||
+                       (Operands[0] == Other.Operands[1] && Operands[1] == Other.Operands[0]);
+            }
+            return Operands == Other.Operands;
+        }
+
+        bool contain(const llvm::Value *const Val) const final {
+            return llvm::is_contained(Operands, Val);
+        }
+
+        bool readsMemory() const final { return Opcode == llvm::Instruction::Load; }
+
+        /// @brief A load may be clobbered by any instruction that writes to
+        ///        memory, unless it is a store to another object than the one
+        ///        loaded from (e.g., two distinct allocas or globals).
+        bool mayBeClobberedBy(const llvm::Instruction &Inst) const final;
+
+        Expression replaceValueWith(const llvm::Value *const SrcVal,
+                                    const llvm::Value *const DstVal) const final {
+            llvm::SmallVector<const llvm::Value *, 2> NewOperands(Operands.begin(),
+                                                                  Operands.end());
+            std::replace(NewOperands.begin(), NewOperands.end(), SrcVal, DstVal);
+            return Expression(Opcode, Predicate, Type, SourceType, NewOperands,
+                              Commutative);
+        }
+
+        //
+        using DomainBase<Expression>::DomainIdMap_t;
+
+        using DomainBase<Expression>::DomainVector_t;
+
+        /// @brief Fill the domain with the expressions, and record the id of
+        ///        the expression evaluated by each instruction into
+        ///        @c InstUseIds .
+        struct Initializer : public llvm::InstVisitor<Initializer> {
+            DomainIdMap_t& DomainIdMap;
+            DomainVector_t& DomainVector;
+            InstDomainIdTable& InstUseIds;
+            explicit Initializer(DomainIdMap_t& DomainIdMap,
+                                 DomainVector_t& DomainVector,
+                                 InstDomainIdTable& InstUseIds)
+                    : DomainIdMap(DomainIdMap), DomainVector(DomainVector),
+                      InstUseIds(InstUseIds) {}
+            void visitInstruction(llvm::Instruction &);
+        };
+    };
+
+} // namespace dfa
+
+llvm::raw_ostream &operator<<(llvm::raw_ostream &, const dfa::Expression &);
+
+namespace std {
+
+    template<>
+    struct hash<::dfa::Expression> {
+        /// Commutative operands are hashed in a canonical (address) order, so
+        /// that expressions equal under @c operator== hash the same.
+        size_t operator()(const dfa::Expression &Expr) const {
+            size_t seed = 0;
+            hashCombine(&seed, Expr.Opcode, Expr.Predicate, Expr.Type,
+                        Expr.SourceType);
+            if (Expr.Commutative) {
+                const llvm::Value *First = Expr.Operands[0], *Second = Expr.Operands[1];
+                if (std::less<const llvm::Value *>()(Second, First)) {
+                    std::swap(First, Second);
+                }
+                hashCombine(&seed, First, Second);
+                return seed;
+            }
+            for (const llvm::Value *const Operand : Expr.Operands) {
+                hashCombine(&seed, Operand);
+            }
+            return seed;
+        }
+    };
+
+} // namespace std
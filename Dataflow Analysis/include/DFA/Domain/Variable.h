@@ -1,53 +1,59 @@
-#pragma once // NOLINT(llvm-header-guard)
-
-#include <llvm/IR/InstVisitor.h>
-#include <llvm/IR/Instruction.h>
-#include <llvm/IR/Instructions.h>
-#include <llvm/IR/Value.h>
-#include <llvm/Support/raw_ostream.h>
-#include "Base.h"
-#include "Utility.h"
-
-namespace dfa {
-
-    struct Variable final : DomainBase<Variable> {
-      const llvm::Value *const Var;
-      Variable(const llvm::Value *const Var) : Var(Var) {}
-
-      bool operator==(const Variable &Other) const { return Var == Other.Var; }
-
-      bool contain(const llvm::Value *const Val) const final {
-        return Val == Var;
-      }
-
-      Variable replaceValueWith(const llvm::Value *const SrcVal,
-                                const llvm::Value *const DstVal) const final {
-        return Variable(Var == SrcVal ? DstVal : SrcVal);
-      }
-
-      using DomainBase<Variable>::DomainIdMap_t;
-      using DomainBase<Variable>::DomainVector_t;
-
-      struct Initializer : public llvm::InstVisitor<Initializer> {
-        DomainIdMap_t &DomainIdMap;
-        DomainVector_t &DomainVector;
-        explicit Initializer(DomainIdMap_t &DomainIdMap,
-                             DomainVector_t &DomainVector)
-            : DomainIdMap(DomainIdMap), DomainVector(DomainVector) {}
-        void visitInstruction(llvm::Instruction &I);
-      };
-    };
-
-} // namespace dfa
-
-llvm::raw_ostream &operator<<(llvm::raw_ostream &, const dfa::Variable &);
-
-namespace std {
-
-template <> struct hash<::dfa::Variable> {
-  size_t operator()(const dfa::Variable &Var) const {
-    return hash<const llvm::Value *>()(Var.Var);
-  }
-};
-
-} // namespace std
+#pragma once // NOLINT(llvm-header-guard)
+
+#include <llvm/IR/InstVisitor.h>
+#include <llvm/IR/Instruction.h>
+#include <llvm/IR/Instructions.h>
+#include <llvm/IR/Value.h>
+#include <llvm/Support/raw_ostream.h>
+#include "Base.h"
+#include "Utility.h"
+
+namespace dfa {
+
+    struct Variable final : DomainBase<Variable> {
+      const llvm::Value *const Var;
+      Variable(const llvm::Value *const Var) : Var(Var) {}
+
+      bool operator==(const Variable &Other) const { return Var == Other.Var; }
+
+      bool contain(const llvm::Value *const Val) const final {
+        return Val == Var;
+      }
+
+      Variable replaceValueWith(const llvm::Value *const SrcVal,
+                                const llvm::Value *const DstVal) const final {
+        return Variable(Var == SrcVal ? DstVal : SrcVal);
+      }
+
+      using DomainBase<Variable>::DomainIdMap_t;
+      using DomainBase<Variable>::DomainVector_t;
+
+      /// @brief Fill the domain with the variables used by the instructions,
+      ///        and record the ids of the operands of each instruction (in
+      ///        operand order) into @c InstUseIds .
+      struct Initializer : public llvm::InstVisitor<Initializer> {
+        DomainIdMap_t &DomainIdMap;
+        DomainVector_t &DomainVector;
+        InstDomainIdTable &InstUseIds;
+        explicit Initializer(DomainIdMap_t &DomainIdMap,
+                             DomainVector_t &DomainVector,
+                             InstDomainIdTable &InstUseIds)
+            : DomainIdMap(DomainIdMap), DomainVector(DomainVector),
+              InstUseIds(InstUseIds) {}
+        void visitInstruction(llvm::Instruction &I);
+      };
+    };
+
+} // namespace dfa
+
+llvm::raw_ostream &operator<<(llvm::raw_ostream &, const dfa::Variable &);
+
+namespace std {
+
+template <> struct hash<::dfa::Variable> {
+  size_t operator()(const dfa::Variable &Var) const {
+    return hash<const llvm::Value *>()(Var.Var);
+  }
+};
+
+} // namespace std
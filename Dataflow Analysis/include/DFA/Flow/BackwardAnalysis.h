@@ -1,64 +1,89 @@
-#pragma once // NOLINT(llvm-header-guard)
-
-#include "Framework.h"
-
-/// @todo(CSCD70) Please instantiate for the backward pass, similar to the
-///               forward one.
-/// @sa @c ForwardAnalysis
-
-namespace dfa {
-/// @todo(CSCD70) Please modify the traversal ranges.
-    typedef llvm::iterator_range<llvm::const_succ_iterator> BackwardMeetBBConstRange_t;
-    typedef llvm::iterator_range<std::reverse_iterator<llvm::ilist_iterator<llvm::ilist_detail::node_options<llvm::BasicBlock, false, false, void>, false, true>>> BackwardBBConstRange_t;
-    typedef llvm::iterator_range<llvm::ilist_iterator<llvm::ilist_detail::node_options<llvm::Instruction, false, false, void>, true, true>> BackwardInstConstRange_t;
-    // TDomainElem -> dfa::Expression, TValue -> dfa::Bool,  TMeetOp -> dfa::Intersect<dfa::Bool>
-    template<typename TDomainElem, typename TValue, typename TMeetOp>
-    class BackwardAnalysis
-            : public Framework<TDomainElem, TValue, TMeetOp, BackwardMeetBBConstRange_t,
-                    BackwardBBConstRange_t, BackwardInstConstRange_t> {
-    protected:
-        using Framework_t =
-                Framework<TDomainElem, TValue, TMeetOp, BackwardMeetBBConstRange_t,
-                        BackwardBBConstRange_t, BackwardInstConstRange_t>;
-        using typename Framework_t::AnalysisResult_t;
-        using typename Framework_t::BBConstRange_t;
-        using typename Framework_t::InstConstRange_t;
-        using typename Framework_t::MeetBBConstRange_t;
-
-        using Framework_t::BVs;
-        using Framework_t::DomainIdMap;
-        using Framework_t::DomainVector;
-        using Framework_t::InstDomainValMap;
-
-        using Framework_t::getName;
-        using Framework_t::run;
-        using Framework_t::stringifyDomainWithMask;
-
-        void printInstDomainValMap(const llvm::Instruction &Inst) const final {
-            using llvm::errs;
-            using llvm::outs;
-            const llvm::BasicBlock *const ParentBB = Inst.getParent();
-            outs() << Inst << "\n";
-            LOG_ANALYSIS_INFO << "\t"
-                              << stringifyDomainWithMask(InstDomainValMap.at(&Inst));
-            if (&Inst == &(ParentBB->back())) {
-                LOG_ANALYSIS_INFO << "\t" << stringifyDomainWithMask(BVs.at(ParentBB));
-                errs() << "\n";
-            } // if (&Inst == &(*ParentBB->begin()))
-        }
-
-        MeetBBConstRange_t
-        getMeetBBConstRange(const llvm::BasicBlock &BB) const final {
-            return llvm::successors(&BB);
-        }
-
-        InstConstRange_t getInstConstRange(const llvm::BasicBlock &BB) const final {
-            return llvm::reverse(BB);
-        }
-
-        BBConstRange_t getBBConstRange(const llvm::Function &F) const final {
-            return llvm::reverse(F);
-        }
-    };
-
-} // namespace dfa
+#pragma once // NOLINT(llvm-header-guard)
+
+#include "Framework.h"
+
+/// @todo(CSCD70) Please instantiate for the backward pass, similar to the
+///               forward one.
+/// @sa @c ForwardAnalysis
+
+namespace dfa {
+/// @todo(CSCD70) Please modify the traversal ranges.
+    typedef llvm::iterator_range<llvm::const_succ_iterator> BackwardMeetBBConstRange_t;
+    typedef llvm::iterator_range<llvm::const_pred_iterator> BackwardDependentBBConstRange_t;
+    typedef std::vector<const llvm::BasicBlock *> BackwardBBConstRange_t;
+    typedef llvm::iterator_range<llvm::ilist_iterator<llvm::ilist_detail::node_options<llvm::Instruction, false, false, void>, true, true>> BackwardInstConstRange_t;
+    // TDomainElem -> dfa::Expression, TValue -> dfa::Bool,  TMeetOp -> dfa::Intersect<dfa::Bool>
+    template<typename TDerived, typename TDomainElem, typename TValue,
+            typename TMeetOp>
+    class BackwardAnalysis
+            : public Framework<TDerived, TDomainElem, TValue, TMeetOp, BackwardMeetBBConstRange_t,
+                    BackwardDependentBBConstRange_t, BackwardBBConstRange_t,
+                    BackwardInstConstRange_t> {
+    protected:
+        using Framework_t =
+                Framework<TDerived, TDomainElem, TValue, TMeetOp, BackwardMeetBBConstRange_t,
+                        BackwardDependentBBConstRange_t, BackwardBBConstRange_t,
+                        BackwardInstConstRange_t>;
+        using Framework_t::Framework_t;
+        friend Framework_t;
+        using typename Framework_t::AnalysisResult_t;
+        using typename Framework_t::BBConstRange_t;
+        using typename Framework_t::DependentBBConstRange_t;
+        using typename Framework_t::InstConstRange_t;
+        using typename Framework_t::MeetBBConstRange_t;
+
+        using Framework_t::BVs;
+        using Framework_t::DomainIdMap;
+        using Framework_t::DomainVector;
+        using Framework_t::InstDomainValMap;
+        using Framework_t::InstDefIds;
+        using Framework_t::InstUseIds;
+        using Framework_t::ScratchVal;
+
+        using Framework_t::appendRemainingBBs;
+        using Framework_t::errs;
+        using Framework_t::outs;
+        using Framework_t::getName;
+        using Framework_t::getBoundaryVal;
+        using Framework_t::getValueAt;
+        using Framework_t::run;
+        using Framework_t::stringifyDomainWithMask;
+
+        void printInstDomainValMap(const llvm::Instruction &Inst) final {
+            const llvm::BasicBlock *const ParentBB = Inst.getParent();
+            outs() << Inst << "\n";
+            LOG_ANALYSIS_INFO << "\t"
+                              << stringifyDomainWithMask(getValueAt(Inst));
+            if (&Inst == &(ParentBB->back())) {
+                LOG_ANALYSIS_INFO << "\t" << stringifyDomainWithMask(getBoundaryVal(*ParentBB));
+                errs() << "\n";
+            } // if (&Inst == &(*ParentBB->begin()))
+        }
+
+        MeetBBConstRange_t
+        getMeetBBConstRange(const llvm::BasicBlock &BB) const {
+            return llvm::successors(&BB);
+        }
+
+        DependentBBConstRange_t
+        getDependentBBConstRange(const llvm::BasicBlock &BB) const {
+            return llvm::predecessors(&BB);
+        }
+
+        InstConstRange_t getInstConstRange(const llvm::BasicBlock &BB) const {
+            return llvm::reverse(BB);
+        }
+
+        BBConstRange_t getBBConstRange(const llvm::Function &F) const {
+            // post-order, so that (except for back edges) a block is visited
+            // after all its successors
+            BBConstRange_t Order;
+            for (const llvm::BasicBlock *BB : llvm::post_order(&F.getEntryBlock())) {
+                Order.push_back(BB);
+            }
+            appendRemainingBBs(F, Order);
+            return Order;
+        }
+    };
+
+} // namespace dfa
@@ -1,64 +1,95 @@
-#pragma once // NOLINT(llvm-header-guard)
-
-#include "Framework.h"
-
-namespace dfa {
-
-/// @todo(CSCD70) Please modify the traversal ranges.
-
-    typedef llvm::iterator_range<llvm::const_pred_iterator>
-            ForwardMeetBBConstRange_t;
-    typedef llvm::iterator_range<llvm::Function::const_iterator>
-            ForwardBBConstRange_t;
-    typedef llvm::iterator_range<llvm::BasicBlock::const_iterator>
-            ForwardInstConstRange_t;
-
-    template <typename TDomainElem, typename TValue, typename TMeetOp>
-    class ForwardAnalysis
-            : public Framework<TDomainElem, TValue, TMeetOp, ForwardMeetBBConstRange_t,
-                    ForwardBBConstRange_t, ForwardInstConstRange_t> {
-    protected:
-        using Framework_t =
-                Framework<TDomainElem, TValue, TMeetOp, ForwardMeetBBConstRange_t,
-                        ForwardBBConstRange_t, ForwardInstConstRange_t>;
-        using typename Framework_t::AnalysisResult_t;
-        using typename Framework_t::BBConstRange_t;
-        using typename Framework_t::InstConstRange_t;
-        using typename Framework_t::MeetBBConstRange_t;
-
-        using Framework_t::BVs;
-        using Framework_t::DomainIdMap;
-        using Framework_t::DomainVector;
-        using Framework_t::InstDomainValMap;
-
-        using Framework_t::getName;
-        using Framework_t::run;
-        using Framework_t::stringifyDomainWithMask;
-
-        void printInstDomainValMap(const llvm::Instruction &Inst) const final {
-            using llvm::errs;
-            using llvm::outs;
-            const llvm::BasicBlock *const ParentBB = Inst.getParent();
-
-            if (&Inst == &(ParentBB->front())) {
-                errs() << "\n";
-                LOG_ANALYSIS_INFO << "\t" << stringifyDomainWithMask(BVs.at(ParentBB));
-            } // if (&Inst == &(*ParentBB->begin()))
-            outs() << Inst << "\n";
-            LOG_ANALYSIS_INFO << "\t"
-                              << stringifyDomainWithMask(InstDomainValMap.at(&Inst));
-        }
-
-        MeetBBConstRange_t
-        getMeetBBConstRange(const llvm::BasicBlock &BB) const final {
-            return llvm::predecessors(&BB);
-        }
-        InstConstRange_t getInstConstRange(const llvm::BasicBlock &BB) const final {
-            return make_range(BB.begin(), BB.end());
-        }
-        BBConstRange_t getBBConstRange(const llvm::Function &F) const final {
-            return make_range(F.begin(), F.end());
-        }
-    };
-
+#pragma once // NOLINT(llvm-header-guard)
+
+#include "Framework.h"
+
+namespace dfa {
+
+/// @todo(CSCD70) Please modify the traversal ranges.
+
+    typedef llvm::iterator_range<llvm::const_pred_iterator>
+            ForwardMeetBBConstRange_t;
+    typedef llvm::iterator_range<llvm::const_succ_iterator>
+            ForwardDependentBBConstRange_t;
+    typedef std::vector<const llvm::BasicBlock *> ForwardBBConstRange_t;
+    typedef llvm::iterator_range<llvm::BasicBlock::const_iterator>
+            ForwardInstConstRange_t;
+
+    template<typename TDerived, typename TDomainElem, typename TValue,
+            typename TMeetOp>
+    class ForwardAnalysis
+            : public Framework<TDerived, TDomainElem, TValue, TMeetOp, ForwardMeetBBConstRange_t,
+                    ForwardDependentBBConstRange_t, ForwardBBConstRange_t,
+                    ForwardInstConstRange_t> {
+    protected:
+        using Framework_t =
+                Framework<TDerived, TDomainElem, TValue, TMeetOp, ForwardMeetBBConstRange_t,
+                        ForwardDependentBBConstRange_t, ForwardBBConstRange_t,
+                        ForwardInstConstRange_t>;
+        using Framework_t::Framework_t;
+        friend Framework_t;
+        using typename Framework_t::AnalysisResult_t;
+        using typename Framework_t::BBConstRange_t;
+        using typename Framework_t::DependentBBConstRange_t;
+        using typename Framework_t::InstConstRange_t;
+        using typename Framework_t::MeetBBConstRange_t;
+
+        using Framework_t::BVs;
+        using Framework_t::DomainIdMap;
+        using Framework_t::DomainVector;
+        using Framework_t::InstDomainValMap;
+        using Framework_t::InstDefIds;
+        using Framework_t::InstUseIds;
+        using Framework_t::ScratchVal;
+
+        using Framework_t::appendRemainingBBs;
+        using Framework_t::errs;
+        using Framework_t::outs;
+        using Framework_t::getName;
+        using Framework_t::getBoundaryVal;
+        using Framework_t::getValueAt;
+        using Framework_t::run;
+        using Framework_t::stringifyDomainWithMask;
+
+        void printInstDomainValMap(const llvm::Instruction &Inst) final {
+            const llvm::BasicBlock *const ParentBB = Inst.getParent();
+
+            if (&Inst == &(ParentBB->front())) {
+                errs() << "\n";
+                LOG_ANALYSIS_INFO << "\t" << stringifyDomainWithMask(getBoundaryVal(*ParentBB));
+            } // if (&Inst == &(*ParentBB->begin()))
+            outs() << Inst << "\n";
+            LOG_ANALYSIS_INFO << "\t"
+                              << stringifyDomainWithMask(getValueAt(Inst));
+        }
+
+        /// @brief Get the list of basic blocks to which the meet operator will be
+        ///        applied.
+        MeetBBConstRange_t
+        getMeetBBConstRange(const llvm::BasicBlock &BB) const {
+            return llvm::predecessors(&BB);
+        }
+        /// @brief Get the list of basic blocks that have to be revisited once the
+        ///        output of @p BB changes, i.e., the inverse of
+        ///        @c getMeetBBConstRange .
+        DependentBBConstRange_t
+        getDependentBBConstRange(const llvm::BasicBlock &BB) const {
+            return llvm::successors(&BB);
+        }
+        /// @brief Get the list of instructions from the basic block, in the
+        ///        direction of the analysis.
+        InstConstRange_t getInstConstRange(const llvm::BasicBlock &BB) const {
+            return make_range(BB.begin(), BB.end());
+        }
+        /// @brief Get the list of basic blocks from the function, from which
+        ///        the weak topological ordering of @c traverseCFG is built.
+        BBConstRange_t getBBConstRange(const llvm::Function &F) const {
+            // reverse post-order, so that (except for back edges) a block is
+            // visited after all its predecessors
+            llvm::ReversePostOrderTraversal<const llvm::Function *> RPOT(&F);
+            BBConstRange_t Order(RPOT.begin(), RPOT.end());
+            appendRemainingBBs(F, Order);
+            return Order;
+        }
+    };
+
 } // namespace dfa
\ No newline at end of file
@@ -1,330 +1,1672 @@
-#pragma once // NOLINT(llvm-header-guard)
-
-#include <llvm/IR/Function.h>
-#include <llvm/IR/InstIterator.h>
-#include <llvm/IR/PassManager.h>
-#include <llvm/Support/raw_ostream.h>
-#include <iostream>
-#include <tuple>
-#include <cxxabi.h>
-#include <llvm/Analysis/ValueLattice.h>
-#include "Utility.h"
-
-namespace dfa {
-
-
-
-    template<typename TValue>
-    struct ValuePrinter {
-        static std::string print(const TValue &V) { return ""; }
-    };
-
-    template<typename TDomainElem, typename TValue, typename TMeetOp,
-            typename TMeetBBConstRange, typename TBBConstRange,
-            typename TInstConstRange>
-    class Framework {
-    protected:
-        // Maps Id =>
-        using DomainIdMap_t = typename TDomainElem::DomainIdMap_t;
-        //
-        using DomainVector_t = typename TDomainElem::DomainVector_t;
-        //
-        using DomainVal_t = typename TMeetOp::DomainVal_t;
-        //
-        using Initializer = typename TDomainElem::Initializer;
-        //
-        using MeetOperands_t = std::vector<DomainVal_t>;
-        //
-        using MeetBBConstRange_t = TMeetBBConstRange;
-        //
-        using BBConstRange_t = TBBConstRange;
-        //
-        using InstConstRange_t = TInstConstRange;
-        // Analysis Result is The result of the data flow analysis
-        // DomainIdMap?
-        //
-        using AnalysisResult_t =
-                std::tuple<DomainIdMap_t, DomainVector_t,
-                        std::unordered_map<const llvm::BasicBlock *, DomainVal_t>,
-                        std::unordered_map<const llvm::Instruction *, DomainVal_t>>;
-
-        DomainIdMap_t DomainIdMap;
-        DomainVector_t DomainVector;
-        std::unordered_map<const llvm::BasicBlock *, DomainVal_t> BVs;
-        std::unordered_map<const llvm::Instruction *, DomainVal_t> InstDomainValMap;
-        std::unordered_map<const llvm::Instruction *, bool> InstExecutable;
-
-        /// @name Print utility functions
-        /// @{
-
-        std::string stringifyDomainWithMask(const DomainVal_t &Mask) const {
-            std::string StringBuf;
-            llvm::raw_string_ostream Strout(StringBuf);
-            Strout << "{";
-            CHECK(Mask.size() == DomainIdMap.size() &&
-                  Mask.size() == DomainVector.size())
-                << "The size of mask must be equal to the size of domain, but got Masks size: "
-                << Mask.size() << " Domain Id Map size: " << DomainIdMap.size() << " Domain Vector size: "
-                << DomainVector.size();
-            for (size_t DomainId = 0; DomainId < DomainIdMap.size(); ++DomainId) {
-                if (!static_cast<bool>(Mask[DomainId])) {
-                    continue;
-                }
-                Strout << DomainVector.at(DomainId)
-                       << ValuePrinter<TValue>::print(Mask[DomainId]) << ", ";
-            } // for (MaskIdx : [0, Mask.size()))
-            Strout << "}";
-            return StringBuf;
-        }
-
-        virtual void printInstDomainValMap(const llvm::Instruction &Inst) const = 0;
-
-        void printInstDomainValMap(const llvm::Function &F) const {
-            using llvm::errs;
-            for (const llvm::Instruction &Inst: llvm::instructions(&F)) {
-                printInstDomainValMap(Inst);
-            }
-        }
-
-        virtual std::string getName() const = 0;
-
-        /// @}
-        /// @name Boundary values
-        /// @{
-        DomainVal_t getBoundaryVal(const llvm::BasicBlock &BB) const {
-            using llvm::outs;
-            MeetOperands_t MeetOperands = getMeetOperands(BB);
-            // if bb has no meet operands then initialVal ← Boundary Condition;
-            if (MeetOperands.empty()) {
-                // TMeetOp meetOp;
-                // return meetOp.top(DomainVector.size());
-                return bc();
-            }
-            // initialVal ← MeetOp(MeetOperands(bb));
-            return meet(MeetOperands);
-        }
-
-        /// @brief Get the list of basic blocks to which the meet operator will be
-        ///        applied.
-        /// @param BB
-        /// @return
-        virtual MeetBBConstRange_t
-        getMeetBBConstRange(const llvm::BasicBlock &BB) const = 0;
-
-        /// @brief Get the list of domain values to which the meet operator will be
-        ///        applied.
-        /// @param BB
-        /// @return
-        /// @sa @c getMeetBBConstRange
-        virtual MeetOperands_t getMeetOperands(const llvm::BasicBlock &BB) const {
-            MeetOperands_t Operands;
-            using llvm::outs;
-            /// @todo(CSCD70) Please complete this method.
-            for (const llvm::BasicBlock* bb : getMeetBBConstRange(BB)) {
-                const llvm::Instruction* operands;
-                for (const llvm::Instruction& I : getInstConstRange(*bb)) {
-                    operands = &I;
-                }
-                Operands.push_back(InstDomainValMap.at(operands));
-            }
-            return Operands;
-        }
-
-        DomainVal_t bc() const { return DomainVal_t(DomainIdMap.size()); }
-
-        DomainVal_t meet(const MeetOperands_t &MeetOperands) const {
-            /// apply meet operator repeatedly until we finish
-            DomainVal_t meetVal = MeetOperands[0];
-            TMeetOp meetOp;
-            for (int i = 1; i < MeetOperands.size(); i++) {
-                meetVal = meetOp(meetVal, MeetOperands[i]);
-            }
-            return meetVal;
-        }
-
-        /// @}
-        /// @name CFG traversal
-        /// @{
-
-        /// @brief Get the list of basic blocks from the function.
-        /// @param F
-        /// @return
-        virtual BBConstRange_t getBBConstRange(const llvm::Function &F) const = 0;
-
-        /// @brief Get the list of instructions from the basic block.
-        /// @param BB
-        /// @return
-        virtual InstConstRange_t
-        getInstConstRange(const llvm::BasicBlock &BB) const = 0;
-
-        /// @brief Traverse through the CFG of the function.
-        /// @param F
-        /// @return True if either BasicBlock-DomainValue mapping or
-        ///         Instruction-DomainValue mapping has been modified, false
-        ///         otherwise.
-        bool traverseCFG(const llvm::Function &F) {
-            using llvm::outs;
-            bool Changed = false;
-            for(const llvm::BasicBlock& bb : getBBConstRange(F)) {
-                 DomainVal_t IDV = getBoundaryVal(bb);
-                 // Update boundary value
-                 BVs[&bb] = IDV;
-                 DomainVal_t ODV(DomainVector.size());
-
-                 // check if boundary values changed
-                 for (const llvm::Instruction& I : getInstConstRange(bb)) {
-                     if (transferFunc(I, IDV, ODV)) {
-                         Changed = true;
-                     };
-                     IDV = ODV;
-                     // store instruction into value map
-                     InstDomainValMap[&I] = IDV;
-                 }
-            }
-            return Changed;
-        }
-
-        /// @}
-
-        virtual ~Framework() {}
-
-        /// @brief Apply the transfer function to the input domain value at
-        ///        instruction @p inst .
-        /// @param Inst instructions
-        /// @param IDV input domain value
-        /// @param ODV output domain value
-        /// @return Whether the output domain value is to be changed.
-        virtual bool transferFunc(const llvm::Instruction &Inst,
-                                  const DomainVal_t &IDV, DomainVal_t &ODV) = 0;
-
-        virtual AnalysisResult_t run(llvm::Function &F,
-                                     llvm::FunctionAnalysisManager &FAM) {
-            // using llvm::outs;
-            // initialize domain
-            Initializer initializer(DomainIdMap, DomainVector);
-            initializer.visit(F);
-            TMeetOp meetOp;
-            for (auto &bb : F) {
-                BVs[&bb] = bc();
-                for (auto &inst : bb)  {
-                    InstDomainValMap[&inst] = bc();
-                    // whether or not the current instruction is executable
-                    // used for sparse conditional execution
-                    InstExecutable[&inst] = false;
-                }
-            }
-            // always mark the first instruction as executable
-            llvm::Instruction& FirstInstr = F.front().front();
-            InstExecutable[&FirstInstr] = true;
-
-            bool Changed;
-            do {
-                Changed = traverseCFG(F);
-            } while (Changed);
-            //// debug output print
-            printInstDomainValMap(F);
-            return std::make_tuple(DomainIdMap, DomainVector, BVs, InstDomainValMap);
-        }
-
-    }; // class Framework
-
-    /// @brief For each domain element type, we have to define:
-    ///        - The default constructor
-    ///        - The meet operators (for intersect/union)
-    ///        - The top element
-    ///        - Conversion to bool (for logging)
-    struct Bool {
-        bool Value = false;
-
-        Bool operator&(const Bool &Other) const {
-            return {.Value = Value && Other.Value};
-        }
-
-        Bool operator|(const Bool &Other) const {
-            return {.Value = Value || Other.Value};
-        }
-
-        static Bool top() { return {.Value = true }; }
-
-        explicit operator bool() const { return Value; }
-    };
-
-    /// @brief For each domain element type, we have to define:
-    ///        - The default constructor
-    ///        - The meet operators (for intersect/union)
-    ///        - The top element
-    ///        - Conversion to bool (for logging)
-    struct Lattice {
-        // (Top Element) => not defined
-        enum LatticeElement {
-            undef,
-            overdef,
-            constant
-        };
-        llvm::ConstantInt* Constant = nullptr;
-        LatticeElement state = LatticeElement::undef;
-
-        void markOverdef() {
-            state = LatticeElement::overdef;
-            Constant = nullptr;
-        }
-
-        void markConstant(llvm::ConstantInt* c) {
-            state = LatticeElement::constant;
-            Constant = c;
-        }
-
-        bool isConstant() {
-            return LatticeElement::constant == state;
-        }
-
-        bool isOverdef() {
-            return LatticeElement::overdef == state;
-        }
-
-        bool isUndef() {
-            return LatticeElement::undef == state;
-        }
-
-        Lattice operator&(const Lattice &Other) const {
-            Lattice currentCopy = *this;
-            using llvm::outs;
-            if (Other.state == LatticeElement::undef) {
-                return currentCopy;
-            } else if (Other.state == LatticeElement::overdef || state == LatticeElement::overdef) {
-                currentCopy.markOverdef();
-                return currentCopy;
-            } else if (state == LatticeElement::undef) {
-                Lattice otherCopy = Other;
-                return otherCopy;
-            }
-            // both state should be constant
-            assert(Constant != nullptr && Other.Constant != nullptr);
-            assert(state == LatticeElement::constant && Other.state == LatticeElement::constant);
-            llvm::Constant *cmp = llvm::ConstantExpr::getCompare(llvm::CmpInst::ICMP_EQ, Constant, Other.Constant);
-
-            if (!cmp->isOneValue()) {
-                // if value is not the same get
-                currentCopy.markOverdef();
-            }
-            return currentCopy;
-        }
-
-        static Lattice top() { return Lattice(); }
-
-
-        bool operator==(const Lattice &Other) const  {
-            if (state == LatticeElement::constant && Other.state == LatticeElement::constant) {
-                llvm::Constant *cmp = llvm::ConstantExpr::getCompare(llvm::CmpInst::ICMP_EQ, Constant, Other.Constant);
-                return cmp->isOneValue();
-            } else if (state == Other.state) {
-                return true;
-            }
-            return false;
-        }
-
-        explicit operator bool() const { return state == LatticeElement::constant; }
-
-    };
-
+#pragma once // NOLINT(llvm-header-guard)
+
+#include <llvm/ADT/APInt.h>
+#include <llvm/ADT/BitVector.h>
+#include <llvm/ADT/DenseMap.h>
+#include <llvm/ADT/PostOrderIterator.h>
+#include <llvm/ADT/STLExtras.h>
+#include <llvm/ADT/SmallVector.h>
+#include <llvm/IR/CFG.h>
+#include <llvm/IR/Constants.h>
+#include <llvm/IR/Function.h>
+#include <llvm/IR/InstIterator.h>
+#include <llvm/IR/PassManager.h>
+#include <llvm/Pass.h>
+#include <llvm/Support/Compiler.h>
+#include <llvm/Support/Timer.h>
+#include <llvm/Support/raw_ostream.h>
+#include <algorithm>
+#include <iostream>
+#include <limits>
+#include <list>
+#include <tuple>
+#include <type_traits>
+#include <unordered_set>
+#include <cxxabi.h>
+#include <llvm/Analysis/ValueLattice.h>
+#include "DFA/Domain/Base.h"
+#include "DFA/Flow/ResultCache.h"
+#include "DFA/Flow/Statistics.h"
+#include "Utility.h"
+
+namespace dfa {
+
+    class ModuleSummaries;
+
+    /// @brief How the results are printed after the analysis.
+    enum class OutputMode {
+        /// Every domain set of every instruction, as the elements it holds.
+        Dump,
+        /// Nothing.
+        Quiet,
+        /// The domain once, then every set as the list of its element ids, on
+        /// the output stream only (see @c streamResults ).
+        Stream
+    };
+
+    /// @brief Options shared by all the dataflow analyses, parsed from the
+    ///        pipeline parameters (e.g., @c avail-expr<stats> ).
+    struct Options {
+        /// Print the solver counters after the analysis results.
+        bool PrintStats = false;
+        /// Only keep the block boundary values of gen/kill analyses, and
+        /// recompute the per-instruction ones on demand (see @c getValueAt ).
+        bool Lazy = false;
+        /// Number of recently materialized blocks kept in lazy mode, besides
+        /// the last one, which is always kept so that the instructions of a
+        /// block are replayed once when queried in order.
+        unsigned LazyCacheSize = 0;
+        /// Solve the block boundary values with the sparse engine of the
+        /// analysis, if it has one (see @c solveSparse ).
+        bool Sparse = false;
+        /// Also run the dense engine after the sparse one, and abort if their
+        /// block boundary values differ.
+        bool CrossCheck = false;
+        /// Rewrite the function with the results, for the analyses that come
+        /// with a transformation (e.g., @c const-prop<transform> ).
+        bool Transform = false;
+        /// Directory of the cached results (see @c ResultCache ), which are
+        /// loaded instead of solving the unchanged functions. Empty to solve
+        /// every function.
+        std::string CacheDir;
+        /// File the counters of every function are appended to, as JSON lines
+        /// (see @c appendStatsReport ). Empty for no report.
+        std::string StatsReport;
+        OutputMode Output = OutputMode::Dump;
+        /// Time the phases of the analysis under @c -time-passes . Turned off
+        /// by @c dfa-parallel , whose workers would share the timers.
+        bool TimePhases = true;
+    };
+
+    template<typename TValue>
+    struct ValuePrinter {
+        static std::string print(const TValue &V) { return ""; }
+    };
+
+    struct Bool;
+
+    /// @brief Boolean domain values are stored as packed bits (see
+    ///        @c DomainValStorage ), hence are printed from plain @c bool .
+    template<>
+    struct ValuePrinter<Bool> {
+        static std::string print(const bool V) { return ""; }
+    };
+
+    /// @brief Get the bytes held by domain value @p Val .
+    inline size_t getDomainValBytes(const llvm::BitVector &Val) {
+        return Val.getMemorySize();
+    }
+
+    /// @brief Write the ids of the elements of @p Val , each preceded by a
+    ///        space.
+    inline void streamDomainVal(llvm::raw_ostream &Outs, const llvm::BitVector &Val) {
+        for (const unsigned Id : Val.set_bits()) {
+            Outs << ' ' << Id;
+        }
+    }
+
+    /// @brief Check whether @p A and @p B hold the same elements. They may
+    ///        differ in size once the domain has grown (see
+    ///        @c Framework::update ), the bits past the end of a value being
+    ///        unset.
+    inline bool sameElems(const llvm::BitVector &A, const llvm::BitVector &B) {
+        if (A.size() == B.size()) {
+            return A == B;
+        }
+        const llvm::BitVector &Short = A.size() < B.size() ? A : B;
+        const llvm::BitVector &Long = A.size() < B.size() ? B : A;
+        if (Short.count() != Long.count()) {
+            return false;
+        }
+        for (const unsigned Id : Short.set_bits()) {
+            if (!Long.test(Id)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /// @brief Apply a gen/kill transfer function word by word, i.e.,
+    ///        @p ODV = @p Gen ∪ ( @p IDV − @p Kill ). The new output is built
+    ///        in @p Scratch , which is then swapped with @p ODV , so that no
+    ///        allocation happens once both are sized.
+    /// @return Whether @p ODV has changed.
+    LLVM_ATTRIBUTE_ALWAYS_INLINE bool
+    applyGenKill(const llvm::BitVector &IDV, const llvm::BitVector &Gen,
+                 const llvm::BitVector &Kill, llvm::BitVector &ODV,
+                 llvm::BitVector &Scratch) {
+        Scratch = IDV;
+        Scratch.reset(Kill);
+        Scratch |= Gen;
+        if (sameElems(Scratch, ODV)) {
+            return false;
+        }
+        std::swap(Scratch, ODV);
+        return true;
+    }
+
+    /// @brief Same as above, with the GEN and KILL sets given as domain ids.
+    /// @return Whether @p ODV has changed.
+    LLVM_ATTRIBUTE_ALWAYS_INLINE bool
+    applyGenKill(const llvm::BitVector &IDV, llvm::ArrayRef<unsigned> GenIds,
+                 llvm::ArrayRef<unsigned> KillIds, llvm::BitVector &ODV,
+                 llvm::BitVector &Scratch) {
+        Scratch = IDV;
+        for (const unsigned Id : KillIds) {
+            if (Id < Scratch.size()) {
+                Scratch.reset(Id);
+            }
+        }
+        for (const unsigned Id : GenIds) {
+            if (Id >= Scratch.size()) {
+                Scratch.resize(Id + 1);
+            }
+            Scratch.set(Id);
+        }
+        if (sameElems(Scratch, ODV)) {
+            return false;
+        }
+        std::swap(Scratch, ODV);
+        return true;
+    }
+
+    /// @brief Dataflow solver, statically bound to the analysis @p TDerived
+    ///        (CRTP), so that the calls from the solver loops into the
+    ///        direction and the analysis are resolved at compile time and can
+    ///        be inlined. @p TDerived provides, besides the traversal ranges
+    ///        of its direction ( @c getMeetBBConstRange ,
+    ///        @c getDependentBBConstRange , @c getBBConstRange and
+    ///        @c getInstConstRange , see @c ForwardAnalysis ):
+    ///
+    ///            bool transferFunc(const llvm::Instruction &Inst,
+    ///                              const DomainVal_t &IDV, DomainVal_t &ODV);
+    ///
+    ///        which applies the transfer function of @p Inst to the input
+    ///        value @p IDV , with @p ODV holding the previous output of
+    ///        @p Inst on entry, and returns whether the output has changed.
+    ///        It may also hide @c initGenKill and @c initVal . The members
+    ///        have to be accessible to the framework, e.g., through a friend
+    ///        declaration.
+    template<typename TDerived, typename TDomainElem, typename TValue,
+            typename TMeetOp, typename TMeetBBConstRange,
+            typename TDependentBBConstRange, typename TBBConstRange,
+            typename TInstConstRange>
+    class Framework {
+    protected:
+        TDerived &derived() { return static_cast<TDerived &>(*this); }
+        const TDerived &derived() const {
+            return static_cast<const TDerived &>(*this);
+        }
+
+        // Maps Id =>
+        using DomainIdMap_t = typename TDomainElem::DomainIdMap_t;
+        //
+        using DomainVector_t = typename TDomainElem::DomainVector_t;
+        //
+        using DomainVal_t = typename TMeetOp::DomainVal_t;
+        //
+        using Initializer = typename TDomainElem::Initializer;
+        //
+        using MeetBBConstRange_t = TMeetBBConstRange;
+        // Blocks whose boundary values depend on the output of a block
+        using DependentBBConstRange_t = TDependentBBConstRange;
+        //
+        using BBConstRange_t = TBBConstRange;
+        //
+        using InstConstRange_t = TInstConstRange;
+        // Analysis Result is The result of the data flow analysis
+        // DomainIdMap?
+        // (the instruction map is left empty in lazy mode, use getValueAt)
+        using AnalysisResult_t =
+                std::tuple<DomainIdMap_t, DomainVector_t,
+                        std::unordered_map<const llvm::BasicBlock *, DomainVal_t>,
+                        std::unordered_map<const llvm::Instruction *, DomainVal_t>>;
+
+        DomainIdMap_t DomainIdMap;
+        DomainVector_t DomainVector;
+        /// Ids of the domain elements each instruction evaluates or uses, as
+        /// recorded by the domain initializer (e.g., the expression of a binary
+        /// operator, or the variables used as operands).
+        InstDomainIdTable InstUseIds;
+        /// Ids of the domain elements that contain (i.e., are defined or
+        /// killed by) the value of each instruction.
+        InstDomainIdTable InstDefIds;
+        /// Ids of the elements that read memory, which the instructions that
+        /// write to memory may also kill (see @c initInstDefIds ).
+        std::vector<unsigned> MemoryIds;
+        /// Reusable buffer for the transfer functions.
+        DomainVal_t ScratchVal;
+        std::unordered_map<const llvm::BasicBlock *, DomainVal_t> BVs;
+        /// Domain value at the exit of each block (in the traversal direction),
+        /// i.e., what the dependent blocks meet over.
+        std::unordered_map<const llvm::BasicBlock *, DomainVal_t> BBOutVals;
+        std::unordered_map<const llvm::Instruction *, DomainVal_t> InstDomainValMap;
+
+        /// Composed GEN/KILL sets of a whole block.
+        struct GenKill_t {
+            DomainVal_t Gen, Kill;
+        };
+        /// Per-block summaries, only populated for gen/kill analyses (see
+        /// @c initGenKill ), which are then iterated at block granularity.
+        std::unordered_map<const llvm::BasicBlock *, GenKill_t> BBGenKills;
+        /// Values of the instructions of a block.
+        using InstVals_t = llvm::DenseMap<const llvm::Instruction *, DomainVal_t>;
+        /// Per-instruction values of the blocks most recently materialized in
+        /// lazy mode, most recently used first.
+        std::list<std::pair<const llvm::BasicBlock *, InstVals_t>> MaterializedBBs;
+
+        const Options Opts;
+        /// Number of times a basic block has been visited, i.e., found dirty
+        /// by the traversal (see @c visitBB ).
+        size_t NumBlockVisits = 0;
+        /// Number of applications of a transfer function, either of an
+        /// instruction or of the GEN/KILL summary of a block.
+        size_t NumTransferCalls = 0;
+        /// Number of iterations over the components of the CFG, counting the
+        /// whole function as one (see @c traverseCFG ).
+        size_t NumRounds = 0;
+        /// Number of applications of the meet operator.
+        mutable size_t NumMeets = 0;
+        /// Streams the instructions and the analysis results are printed to.
+        llvm::raw_ostream *OutStream = &llvm::outs(), *ErrStream = &llvm::errs();
+        /// Summaries of the other functions of the module, if the analysis
+        /// takes the calls into account (see @c DFAInterprocPass ).
+        const ModuleSummaries *Summaries = nullptr;
+
+        explicit Framework(const Options &Opts = Options()) : Opts(Opts) {}
+
+        /// @brief Read the callees and the arguments from @p S , which have to
+        ///        outlive the analysis.
+        void setSummaries(const ModuleSummaries *S) { Summaries = S; }
+
+        /// @name Print utility functions
+        /// @{
+
+        llvm::raw_ostream &outs() const { return *OutStream; }
+        llvm::raw_ostream &errs() const { return *ErrStream; }
+
+        /// @brief Redirect the output of the analysis, which otherwise goes to
+        ///        @c llvm::outs() and @c llvm::errs() .
+        void setOutputStreams(llvm::raw_ostream &Outs, llvm::raw_ostream &Errs) {
+            OutStream = &Outs;
+            ErrStream = &Errs;
+        }
+
+        std::string stringifyDomainWithMask(const DomainVal_t &Mask) const {
+            std::string StringBuf;
+            llvm::raw_string_ostream Strout(StringBuf);
+            Strout << "{";
+            // (a value may be shorter once the domain has grown, see update)
+            CHECK(Mask.size() <= DomainIdMap.size() &&
+                  DomainIdMap.size() == DomainVector.size())
+                << "The size of mask must not exceed the size of domain, but got Masks size: "
+                << Mask.size() << " Domain Id Map size: " << DomainIdMap.size() << " Domain Vector size: "
+                << DomainVector.size();
+            for (size_t DomainId = 0; DomainId < Mask.size(); ++DomainId) {
+                if (!static_cast<bool>(Mask[DomainId])) {
+                    continue;
+                }
+                Strout << DomainVector.at(DomainId)
+                       << ValuePrinter<TValue>::print(Mask[DomainId]) << ", ";
+            } // for (MaskIdx : [0, Mask.size()))
+            Strout << "}";
+            return StringBuf;
+        }
+
+        virtual void printInstDomainValMap(const llvm::Instruction &Inst) = 0;
+
+        void printInstDomainValMap(const llvm::Function &F) {
+            requireDomain();
+            for (const llvm::Instruction &Inst: llvm::instructions(&F)) {
+                printInstDomainValMap(Inst);
+            }
+        }
+
+        /// @brief Write the results of @p F line by line, as
+        ///
+        ///            function <name> <analysis> <domain size>
+        ///            domain <id> <element>          (for every element)
+        ///            block <index> <ids>            (boundary value)
+        ///            inst <index> <ids>             (for every instruction)
+        ///            end
+        ///
+        ///        where the blocks and instructions are numbered in function
+        ///        order. The sets are written straight into the output stream,
+        ///        without being stringified.
+        void streamResults(const llvm::Function &F) {
+            requireDomain();
+            llvm::raw_ostream &Outs = outs();
+            Outs << "function " << F.getName() << ' ' << getName() << ' '
+                 << DomainVector.size() << '\n';
+            for (size_t Id = 0; Id < DomainVector.size(); ++Id) {
+                Outs << "domain " << Id << ' ' << DomainVector[Id] << '\n';
+            }
+            size_t BBIdx = 0, InstIdx = 0;
+            for (const llvm::BasicBlock &BB : F) {
+                Outs << "block " << BBIdx++;
+                streamDomainVal(Outs, getBoundaryVal(BB));
+                Outs << '\n';
+                for (const llvm::Instruction &I : BB) {
+                    Outs << "inst " << InstIdx++;
+                    auto InstValIt = InstDomainValMap.find(&I);
+                    if (InstValIt != InstDomainValMap.end()) {
+                        streamDomainVal(Outs, InstValIt->second);
+                    } else {
+                        // lazy mode
+                        streamDomainVal(Outs, getValueAt(I));
+                    }
+                    Outs << '\n';
+                }
+            }
+            Outs << "end\n";
+        }
+
+        virtual std::string getName() const = 0;
+
+        /// @}
+        /// @name Boundary values
+        /// @{
+        /// @brief Compute the boundary value of @p BB into @p BV , in place:
+        ///        the meet over the outputs of the blocks of
+        ///        @c getMeetBBConstRange , or the boundary condition if there is
+        ///        none. Nothing is allocated once @p BV is sized.
+        /// @param BB
+        /// @param BV
+        void meetBoundaryVal(const llvm::BasicBlock &BB, DomainVal_t &BV) const {
+            TMeetOp meetOp;
+            bool First = true;
+            for (const llvm::BasicBlock *MeetBB : derived().getMeetBBConstRange(BB)) {
+                const DomainVal_t &Operand = BBOutVals.at(MeetBB);
+                if (First) {
+                    BV = Operand;
+                    First = false;
+                    continue;
+                }
+                meetOp.meetInto(BV, Operand);
+                ++NumMeets;
+            }
+            if (First) {
+                assignBC(BV);
+            }
+        }
+
+        DomainVal_t bc() const { return DomainVal_t(DomainIdMap.size()); }
+
+        /// @brief Get the value the block outputs start from, i.e., the
+        ///        boundary condition by default. An analysis over the
+        ///        intersection can start from the full set instead, to get the
+        ///        greatest fixpoint around the loops rather than the least one.
+        DomainVal_t initVal() const { return bc(); }
+
+        /// @brief Same as @c Val=bc() , reusing the storage of @p Val .
+        void assignBC(DomainVal_t &Val) const {
+            if constexpr (std::is_same_v<DomainVal_t, llvm::BitVector>) {
+                Val.reset();
+                Val.resize(DomainIdMap.size());
+            } else {
+                Val.assign(DomainIdMap.size(), typename DomainVal_t::value_type());
+            }
+        }
+
+        /// @}
+        /// @name CFG traversal
+        /// @{
+
+        /// @brief Append the basic blocks of @p F that are not yet in @p Order
+        ///        (i.e., unreachable from the traversal root), so that every block
+        ///        still gets a value.
+        static void appendRemainingBBs(const llvm::Function &F,
+                                       BBConstRange_t &Order) {
+            std::unordered_set<const llvm::BasicBlock *> Visited(Order.begin(),
+                                                                 Order.end());
+            for (const llvm::BasicBlock &BB : F) {
+                if (!Visited.count(&BB)) {
+                    Order.push_back(&BB);
+                }
+            }
+        }
+
+        /// @brief Collect the @c MemoryIds of the domain.
+        void initMemoryIds() {
+            MemoryIds.clear();
+            for (unsigned Id = 0; Id < DomainVector.size(); ++Id) {
+                if (DomainVector[Id].readsMemory()) {
+                    MemoryIds.push_back(Id);
+                }
+            }
+        }
+
+        /// @brief Build the @c InstDefIds of @p I from @c InstUseIds : an
+        ///        element contains the value of an instruction only if it is
+        ///        used by one of its users. An instruction that writes to
+        ///        memory also kills the elements that read what it may write.
+        /// @param I
+        void initInstDefIds(const llvm::Instruction &I) {
+            llvm::SmallVector<unsigned, 8> Ids;
+            for (const llvm::User *U : I.users()) {
+                const auto *UserInst = llvm::dyn_cast<llvm::Instruction>(U);
+                if (UserInst == nullptr) {
+                    continue;
+                }
+                for (const unsigned Id : InstUseIds.lookup(UserInst)) {
+                    if (DomainVector[Id].contain(&I)) {
+                        Ids.push_back(Id);
+                    }
+                }
+            }
+            if (I.mayWriteToMemory()) {
+                for (const unsigned Id : MemoryIds) {
+                    if (DomainVector[Id].mayBeClobberedBy(I)) {
+                        Ids.push_back(Id);
+                    }
+                }
+            }
+            llvm::sort(Ids);
+            Ids.erase(std::unique(Ids.begin(), Ids.end()), Ids.end());
+            InstDefIds.insert(&I, Ids);
+        }
+
+        void initInstDefIds(const llvm::Function &F) {
+            for (const llvm::Instruction &I : llvm::instructions(&F)) {
+                initInstDefIds(I);
+            }
+        }
+
+        /// @brief Compose the GEN/KILL sets of the instructions of @p BB into
+        ///        its entry of @c BBGenKills .
+        /// @param BB
+        /// @return False if the analysis does not have the gen/kill form.
+        bool initBBGenKill(const llvm::BasicBlock &BB) {
+            if constexpr (std::is_same_v<DomainVal_t, llvm::BitVector>) {
+                GenKill_t Summary{bc(), bc()};
+                for (const llvm::Instruction &I : derived().getInstConstRange(BB)) {
+                    DomainVal_t Gen = bc(), Kill = bc();
+                    if (!derived().initGenKill(I, Gen, Kill)) {
+                        return false;
+                    }
+                    // GEN = Gen_I ∪ (GEN − Kill_I), KILL = KILL ∪ Kill_I
+                    Summary.Gen.reset(Kill);
+                    Summary.Gen |= Gen;
+                    Summary.Kill |= Kill;
+                }
+                BBGenKills[&BB] = std::move(Summary);
+                return true;
+            }
+            return false;
+        }
+
+        /// @brief Compose the GEN/KILL sets of every block into @c BBGenKills .
+        /// @param F
+        /// @return False if the analysis does not have the gen/kill form.
+        bool initBBGenKills(const llvm::Function &F) {
+            for (const llvm::BasicBlock &BB : F) {
+                if (!initBBGenKill(BB)) {
+                    BBGenKills.clear();
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        /// @brief Apply the transfer function over a basic block, either through
+        ///        its GEN/KILL summary or instruction by instruction.
+        /// @param BB
+        /// @return True if the output of the block has changed, or if any of the
+        ///         instructions reported a change.
+        bool traverseBB(const llvm::BasicBlock &BB) {
+            ++NumBlockVisits;
+            // Update boundary value
+            DomainVal_t &BV = BVs.at(&BB);
+            meetBoundaryVal(BB, BV);
+            DomainVal_t &BBODV = BBOutVals.at(&BB);
+            if constexpr (std::is_same_v<DomainVal_t, llvm::BitVector>) {
+                if (!BBGenKills.empty()) {
+                    const GenKill_t &Summary = BBGenKills.at(&BB);
+                    ++NumTransferCalls;
+                    return applyGenKill(BV, Summary.Gen, Summary.Kill, BBODV,
+                                        ScratchVal);
+                }
+            }
+            bool Changed = false;
+            // each instruction reads the output of the previous one in place
+            const DomainVal_t *IDV = &BV;
+            for (const llvm::Instruction &I : derived().getInstConstRange(BB)) {
+                // the previous output is updated in place
+                DomainVal_t &ODV = InstDomainValMap[&I];
+                ++NumTransferCalls;
+                if (derived().transferFunc(I, *IDV, ODV)) {
+                    Changed = true;
+                }
+                IDV = &ODV;
+            }
+            if (!(*IDV == BBODV)) {
+                BBODV = *IDV;
+                Changed = true;
+            }
+            return Changed;
+        }
+
+        /// @brief Compute the per-instruction domain values of @p BB from its
+        ///        converged boundary value.
+        /// @param BB
+        void traverseInsts(const llvm::BasicBlock &BB) {
+            const DomainVal_t *IDV = &BVs.at(&BB);
+            for (const llvm::Instruction &I : derived().getInstConstRange(BB)) {
+                DomainVal_t &ODV = InstDomainValMap[&I];
+                ++NumTransferCalls;
+                derived().transferFunc(I, *IDV, ODV);
+                IDV = &ODV;
+            }
+        }
+
+        /// @brief Compute the per-instruction domain values from the converged
+        ///        block boundary values, in one final sweep.
+        /// @param F
+        void traverseInsts(const llvm::Function &F) {
+            for (const llvm::BasicBlock &BB : F) {
+                traverseInsts(BB);
+            }
+        }
+
+        /// @brief An element of a weak topological ordering (WTO): either a
+        ///        single block, or a component, i.e., a head block followed by
+        ///        the (nested) WTO of the rest of a strongly connected
+        ///        component of the CFG. Blocks are given as indices into the
+        ///        order of @c getBBConstRange .
+        struct WTOElement {
+            size_t Head;
+            std::vector<WTOElement> Body;
+            bool IsComponent;
+        };
+
+        /// @brief Per-block scratch space of @c buildWTO , shared by its
+        ///        recursive calls, each of which is done with it before
+        ///        recursing.
+        struct WTOScratch {
+            static constexpr size_t Unvisited = std::numeric_limits<size_t>::max();
+            /// @c Member[Idx]==Stamp marks the blocks of the current subgraph.
+            std::vector<size_t> Member, DFSNum, LowLink;
+            std::vector<bool> OnStack;
+            size_t Stamp = 0;
+
+            explicit WTOScratch(const size_t NumBBs)
+                    : Member(NumBBs, 0), DFSNum(NumBBs), LowLink(NumBBs),
+                      OnStack(NumBBs, false) {}
+        };
+
+        /// The traversal of the CFG, built on the first @c traverseCFG .
+        struct {
+            /// Blocks in the order of @c getBBConstRange .
+            BBConstRange_t Order;
+            /// Dependents of every block, as indices into @c Order .
+            std::vector<std::vector<size_t>> Succs;
+            std::vector<WTOElement> WTO;
+            /// Blocks to be visited, reused across the solves.
+            std::vector<bool> Dirty;
+        } Traversal;
+
+        /// @brief Decompose the subgraph over the blocks @p Nodes into its
+        ///        strongly connected components, in topological order, and
+        ///        each non-trivial one recursively into its head (the block
+        ///        that comes first in the order, i.e., the loop header if the
+        ///        loop is reducible) and the components of the rest.
+        /// @param Succs The dependents of every block, as indices.
+        /// @param Nodes Sorted by index.
+        /// @param WTO The elements are appended to it.
+        static void buildWTO(const std::vector<std::vector<size_t>> &Succs,
+                             const std::vector<size_t> &Nodes, WTOScratch &Scratch,
+                             std::vector<WTOElement> &WTO) {
+            const size_t Stamp = ++Scratch.Stamp;
+            for (const size_t Node : Nodes) {
+                Scratch.Member[Node] = Stamp;
+                Scratch.DFSNum[Node] = WTOScratch::Unvisited;
+            }
+
+            // Tarjan's algorithm, without recursion, with the DFS started from
+            // the blocks in order; it yields the components sinks first
+            std::vector<size_t> SCCStack;
+            std::vector<std::pair<size_t, size_t>> CallStack;
+            std::vector<std::vector<size_t>> SCCs;
+            size_t NextDFSNum = 0;
+            for (const size_t Root : Nodes) {
+                if (Scratch.DFSNum[Root] != WTOScratch::Unvisited) {
+                    continue;
+                }
+                CallStack.emplace_back(Root, 0);
+                while (!CallStack.empty()) {
+                    const size_t Node = CallStack.back().first;
+                    size_t &SuccIdx = CallStack.back().second;
+                    if (SuccIdx == 0) {
+                        Scratch.DFSNum[Node] = Scratch.LowLink[Node] = NextDFSNum++;
+                        SCCStack.push_back(Node);
+                        Scratch.OnStack[Node] = true;
+                    }
+                    if (SuccIdx < Succs[Node].size()) {
+                        const size_t Succ = Succs[Node][SuccIdx++];
+                        if (Scratch.Member[Succ] != Stamp) {
+                            continue;
+                        }
+                        if (Scratch.DFSNum[Succ] == WTOScratch::Unvisited) {
+                            CallStack.emplace_back(Succ, 0);
+                        } else if (Scratch.OnStack[Succ]) {
+                            Scratch.LowLink[Node] = std::min(Scratch.LowLink[Node],
+                                                             Scratch.DFSNum[Succ]);
+                        }
+                        continue;
+                    }
+                    CallStack.pop_back();
+                    if (!CallStack.empty()) {
+                        const size_t Parent = CallStack.back().first;
+                        Scratch.LowLink[Parent] = std::min(Scratch.LowLink[Parent],
+                                                           Scratch.LowLink[Node]);
+                    }
+                    if (Scratch.LowLink[Node] != Scratch.DFSNum[Node]) {
+                        continue;
+                    }
+                    std::vector<size_t> &SCC = SCCs.emplace_back();
+                    do {
+                        SCC.push_back(SCCStack.back());
+                        SCCStack.pop_back();
+                        Scratch.OnStack[SCC.back()] = false;
+                    } while (SCC.back() != Node);
+                }
+            }
+
+            for (auto SCCIt = SCCs.rbegin(); SCCIt != SCCs.rend(); ++SCCIt) {
+                std::vector<size_t> &SCC = *SCCIt;
+                std::sort(SCC.begin(), SCC.end());
+                const size_t Head = SCC.front();
+                WTO.push_back({Head, {},
+                               SCC.size() > 1 ||
+                               llvm::is_contained(Succs[Head], Head)});
+                if (SCC.size() > 1) {
+                    // the edges into the head are left out of the rest, which
+                    // breaks every cycle through it
+                    SCC.erase(SCC.begin());
+                    buildWTO(Succs, SCC, Scratch, WTO.back().Body);
+                }
+            }
+        }
+
+        /// @brief Traverse through the CFG of the function until a fixpoint is
+        ///        reached, following the weak topological ordering of the
+        ///        blocks (see @c buildWTO ): a component is iterated until its
+        ///        head is stable before moving on to the blocks downstream, and
+        ///        so is every component nested in it within each iteration.
+        ///        A block is only visited if it is seeded, or if the output of
+        ///        a block it depends on has changed since its last visit.
+        /// @param F
+        /// @param Seeds If given, only these blocks are seeded (the others are
+        ///              expected to be consistent with their inputs already).
+        /// @return True if either BasicBlock-DomainValue mapping or
+        ///         Instruction-DomainValue mapping has been modified, false
+        ///         otherwise.
+        bool traverseCFG(
+                const llvm::Function &F,
+                const std::unordered_set<const llvm::BasicBlock *> *Seeds = nullptr) {
+            // the CFG does not change between the solves of an instance
+            if (Traversal.Order.empty()) {
+                initTraversal(F);
+            }
+            for (size_t Idx = 0; Idx < Traversal.Order.size(); ++Idx) {
+                Traversal.Dirty[Idx] =
+                        Seeds == nullptr || Seeds->count(Traversal.Order[Idx]) != 0;
+            }
+            ++NumRounds;
+            return stabilize(Traversal.WTO);
+        }
+
+        /// @brief Build the order, the dependents and the weak topological
+        ///        ordering of the blocks of @p F into @c Traversal .
+        void initTraversal(const llvm::Function &F) {
+            Traversal.Order = derived().getBBConstRange(F);
+            const BBConstRange_t &Order = Traversal.Order;
+            std::unordered_map<const llvm::BasicBlock *, size_t> OrderIdx;
+            for (size_t Idx = 0; Idx < Order.size(); ++Idx) {
+                OrderIdx[Order[Idx]] = Idx;
+            }
+            Traversal.Succs.assign(Order.size(), {});
+            std::vector<size_t> Nodes(Order.size());
+            for (size_t Idx = 0; Idx < Order.size(); ++Idx) {
+                for (const llvm::BasicBlock *Dep :
+                        derived().getDependentBBConstRange(*Order[Idx])) {
+                    Traversal.Succs[Idx].push_back(OrderIdx.at(Dep));
+                }
+                Nodes[Idx] = Idx;
+            }
+            Traversal.Dirty.assign(Order.size(), false);
+            Traversal.WTO.clear();
+            WTOScratch Scratch(Order.size());
+            buildWTO(Traversal.Succs, Nodes, Scratch, Traversal.WTO);
+        }
+
+        /// @brief Visit the block at @p Idx of the order if it is dirty, and
+        ///        mark its dependents dirty if its output has changed.
+        /// @return Whether its output has changed.
+        bool visitBB(const size_t Idx) {
+            if (!Traversal.Dirty[Idx]) {
+                return false;
+            }
+            Traversal.Dirty[Idx] = false;
+            if (!traverseBB(*Traversal.Order[Idx])) {
+                return false;
+            }
+            for (const size_t Succ : Traversal.Succs[Idx]) {
+                Traversal.Dirty[Succ] = true;
+            }
+            return true;
+        }
+
+        /// @brief Iterate @p Elems , and each component among them until its
+        ///        head stays clean. Every edge back to an earlier element goes
+        ///        to the head of a component holding both, so once the head of
+        ///        a component stays clean over an iteration, so does the rest
+        ///        of it.
+        /// @return Whether the output of any block has changed.
+        bool stabilize(const std::vector<WTOElement> &Elems) {
+            bool Changed = false;
+            for (const WTOElement &Elem : Elems) {
+                Changed |= visitBB(Elem.Head);
+                while (Elem.IsComponent) {
+                    Changed |= stabilize(Elem.Body);
+                    if (!Traversal.Dirty[Elem.Head]) {
+                        break;
+                    }
+                    ++NumRounds;
+                    Changed |= visitBB(Elem.Head);
+                }
+            }
+            return Changed;
+        }
+
+        /// @brief Build the domain of @p F , and the id tables over it.
+        void initDomain(llvm::Function &F) {
+            Initializer initializer(DomainIdMap, DomainVector, InstUseIds);
+            initializer.visit(F);
+            initMemoryIds();
+            initInstDefIds(F);
+        }
+
+        /// @brief Build the domain of the function whose results have been read
+        ///        from the cache, unless it has been already. If it does not
+        ///        have the size of the cached values, i.e., if the structural
+        ///        hash has collided, the function is solved instead.
+        void requireDomain() {
+            if (PendingDomainFunc == nullptr) {
+                return;
+            }
+            llvm::Function &F = *PendingDomainFunc;
+            PendingDomainFunc = nullptr;
+            initDomain(F);
+            if (DomainVector.size() != CachedDomainSize) {
+                releaseCachedResult();
+                SparseSolutionOnly = false;
+                solveOverDomain(F, "");
+            }
+        }
+
+        /// @brief Solve @p F over its domain, and store the results into the
+        ///        cache file at @p CachePath unless it is empty.
+        void solveOverDomain(const llvm::Function &F, const llvm::StringRef CachePath) {
+            NumSolvedElems = DomainVector.size();
+            SolvedBBs = initBBGenKills(F);
+            // (the sparse engines set up the block values they keep, if any)
+            SolvedSparse = Opts.Sparse && solveSparse(F);
+            SparseSolutionOnly = SolvedSparse && BVs.empty();
+            // only the instruction-level dense solver needs all the
+            // per-instruction values
+            const bool Lazy = Opts.Lazy && (SolvedBBs || SolvedSparse);
+            if (!SolvedSparse) {
+                initDenseVals(F, Lazy);
+                traverseCFG(F);
+            } else if (Opts.CrossCheck) {
+                crossCheck(F);
+            }
+            if (SparseSolutionOnly) {
+                // (the values are derived on demand)
+            } else if (Lazy) {
+                // only the block boundary values have to be kept
+                BBOutVals.clear();
+                BBGenKills.clear();
+            } else if (SolvedBBs || SolvedSparse) {
+                traverseInsts(F);
+            }
+            if (!CachePath.empty()) {
+                storeCachedResult(F, CachePath);
+            }
+        }
+
+        /// @brief Set up the values of the dense solver, but the
+        ///        per-instruction ones if @p Lazy .
+        void initDenseVals(const llvm::Function &F, const bool Lazy) {
+            for (const llvm::BasicBlock &BB : F) {
+                BVs[&BB] = bc();
+                BBOutVals[&BB] = derived().initVal();
+                if (!Lazy) {
+                    for (const llvm::Instruction &I : BB) {
+                        InstDomainValMap[&I] = bc();
+                    }
+                }
+            }
+        }
+
+        /// @brief Solve @p F again with the dense engine, after the sparse one,
+        ///        and abort if their block boundary values differ. The values
+        ///        of a sparse engine that keeps no block values are derived
+        ///        from its solution first (see @c deriveBlockVals ), and the
+        ///        dense ones are dropped afterwards.
+        /// @param F
+        void crossCheck(const llvm::Function &F) {
+            std::unordered_map<const llvm::BasicBlock *, DomainVal_t> SparseBVs,
+                    SparseOutVals;
+            if (SparseSolutionOnly) {
+                for (const llvm::BasicBlock &BB : F) {
+                    InstVals_t InstVals;
+                    derived().deriveBlockVals(BB, SparseBVs[&BB], &InstVals);
+                    const llvm::Instruction *Last = nullptr;
+                    for (const llvm::Instruction &I : derived().getInstConstRange(BB)) {
+                        Last = &I;
+                    }
+                    SparseOutVals[&BB] = InstVals.lookup(Last);
+                }
+            } else {
+                SparseBVs = BVs;
+                SparseOutVals = BBOutVals;
+            }
+            // (the gen/kill solver does not need the per-instruction values)
+            initDenseVals(F, SolvedBBs);
+            traverseCFG(F);
+            for (const llvm::BasicBlock &BB : F) {
+                CHECK(SparseBVs.at(&BB) == BVs.at(&BB) &&
+                      SparseOutVals.at(&BB) == BBOutVals.at(&BB))
+                    << "Sparse and dense engines disagree at block "
+                    << BB.getName() << ": "
+                    << stringifyDomainWithMask(SparseBVs.at(&BB)) << " vs. "
+                    << stringifyDomainWithMask(BVs.at(&BB));
+            }
+            if (SparseSolutionOnly) {
+                BVs.clear();
+                BBOutVals.clear();
+                InstDomainValMap.clear();
+            }
+        }
+
+        /// @}
+        /// @name Per-instruction queries
+        /// @{
+
+        /// @brief Get the boundary value of @p BB , i.e., its entry of @c BVs ,
+        ///        the one read from the cache, or the one derived from the
+        ///        solution of the sparse engine (see @c deriveBlockVals ).
+        DomainVal_t getBoundaryVal(const llvm::BasicBlock &BB) {
+            requireDomain();
+            DomainVal_t BV;
+            if (SparseSolutionOnly) {
+                derived().deriveBlockVals(BB, BV, nullptr);
+            } else if (CachedRegion != nullptr) {
+                if constexpr (std::is_same_v<DomainVal_t, llvm::BitVector>) {
+                    BV = readCachedVal(CachedBVs.lookup(&BB));
+                }
+            } else {
+                BV = BVs.at(&BB);
+            }
+            return BV;
+        }
+
+        /// @brief Get the output domain value of instruction @p Inst , read
+        ///        from the cache if it is held there. In lazy mode, its whole
+        ///        block is materialized by replaying the transfer function
+        ///        from its boundary value (or derived from the solution of the
+        ///        sparse engine, see @c deriveBlockVals ), and kept (see
+        ///        @c Options::LazyCacheSize ), so that querying the
+        ///        instructions of a block in any order replays it once.
+        /// @param Inst
+        /// @return
+        DomainVal_t getValueAt(const llvm::Instruction &Inst) {
+            requireDomain();
+            auto InstValIt = InstDomainValMap.find(&Inst);
+            if (InstValIt != InstDomainValMap.end()) {
+                DomainVal_t Val = InstValIt->second;
+                Val.resize(DomainVector.size());
+                return Val;
+            }
+            if constexpr (std::is_same_v<DomainVal_t, llvm::BitVector>) {
+                auto CachedIt = CachedInstVals.find(&Inst);
+                if (CachedIt != CachedInstVals.end()) {
+                    return readCachedVal(CachedIt->second);
+                }
+            }
+            const llvm::BasicBlock *BB = Inst.getParent();
+            for (auto CacheIt = MaterializedBBs.begin();
+                 CacheIt != MaterializedBBs.end(); ++CacheIt) {
+                if (CacheIt->first == BB) {
+                    MaterializedBBs.splice(MaterializedBBs.begin(), MaterializedBBs,
+                                           CacheIt);
+                    return CacheIt->second.lookup(&Inst);
+                }
+            }
+            // (reserved, so that the previous value is not moved while the
+            // next one is inserted)
+            InstVals_t InstVals;
+            InstVals.reserve(BB->size());
+            if (SparseSolutionOnly) {
+                DomainVal_t BV;
+                derived().deriveBlockVals(*BB, BV, &InstVals);
+            } else {
+                // (the boundary values read from the cache are not kept)
+                DomainVal_t BV;
+                const DomainVal_t *IDV = &BV;
+                auto BVIt = BVs.find(BB);
+                if (BVIt != BVs.end()) {
+                    IDV = &BVIt->second;
+                } else {
+                    BV = getBoundaryVal(*BB);
+                }
+                for (const llvm::Instruction &I : derived().getInstConstRange(*BB)) {
+                    DomainVal_t &ODV = InstVals[&I];
+                    ODV = bc();
+                    ++NumTransferCalls;
+                    derived().transferFunc(I, *IDV, ODV);
+                    IDV = &ODV;
+                }
+            }
+            if (MaterializedBBs.size() > Opts.LazyCacheSize) {
+                MaterializedBBs.pop_back();
+            }
+            MaterializedBBs.emplace_front(BB, std::move(InstVals));
+            return MaterializedBBs.front().second.lookup(&Inst);
+        }
+
+        /// @}
+        /// @name Solver counters
+        /// @{
+
+        size_t getNumBlockVisits() const { return NumBlockVisits; }
+        size_t getNumTransferCalls() const { return NumTransferCalls; }
+
+        SolverStats getSolverStats() const {
+            SolverStats Stats;
+            Stats.Rounds = NumRounds;
+            Stats.BlockVisits = NumBlockVisits;
+            Stats.TransferCalls = NumTransferCalls;
+            Stats.Meets = NumMeets;
+            Stats.DomainSize =
+                    PendingDomainFunc != nullptr ? CachedDomainSize : DomainVector.size();
+            for (const auto &BV : BVs) {
+                Stats.BytesHeld += getDomainValBytes(BV.second);
+            }
+            for (const auto &InstVal : InstDomainValMap) {
+                Stats.BytesHeld += getDomainValBytes(InstVal.second);
+            }
+            return Stats;
+        }
+
+        /// @}
+
+        virtual ~Framework() {}
+
+        /// @brief Get the GEN and KILL sets of instruction @p Inst , for the
+        ///        analyses whose transfer function has the form
+        ///        OUT = GEN ∪ (IN − KILL), independent of IN.
+        /// @param Inst
+        /// @param Gen initially empty
+        /// @param Kill initially empty
+        /// @return False if the analysis does not have that form, in which case
+        ///         it is solved instruction by instruction.
+        bool initGenKill(const llvm::Instruction &Inst, DomainVal_t &Gen,
+                         DomainVal_t &Kill) {
+            return false;
+        }
+
+        /// @brief Get the GEN and KILL sets of instruction @p Inst as domain
+        ///        ids, for the gen/kill analyses that keep them as such (e.g.,
+        ///        @c InstUseIds and @c InstDefIds ), so that a few elements can
+        ///        be brought up to date without going through whole values
+        ///        (see @c update ).
+        /// @return False if the analysis does not keep them, in which case
+        ///         whole values are recomputed.
+        bool getGenKillIds(const llvm::Instruction &Inst,
+                           llvm::ArrayRef<unsigned> &GenIds,
+                           llvm::ArrayRef<unsigned> &KillIds) {
+            return false;
+        }
+
+        /// @brief Derive the boundary value of @p BB into @p BV , and the
+        ///        values of its instructions into @p InstVals unless it is
+        ///        null, from the solution of a sparse engine that keeps no
+        ///        block values (e.g., the lattice cells of @c SCCP ), i.e., that
+        ///        leaves @c BVs empty. They are only derived on demand, one
+        ///        block at a time (see @c getValueAt ).
+        /// @return False if the analysis has no such sparse engine.
+        bool deriveBlockVals(const llvm::BasicBlock &BB, DomainVal_t &BV,
+                             InstVals_t *InstVals) {
+            return false;
+        }
+
+        /// @brief Write the solution of a sparse engine that keeps no block
+        ///        values (see @c deriveBlockVals ) into a cached result.
+        void writeSparseSolution(const llvm::Function &F,
+                                 ResultWriter &Writer) const {}
+
+        /// @brief Read back what @c writeSparseSolution has written, for a
+        ///        domain of @p DomainSize elements.
+        /// @return False if it is not valid.
+        bool readSparseSolution(const llvm::Function &F, ResultReader &Reader,
+                                size_t DomainSize) {
+            return false;
+        }
+
+        /// @brief Solve the block boundary values ( @c BVs and @c BBOutVals )
+        ///        directly over the def-use chains rather than by iterating over
+        ///        the CFG. The per-instruction values are then filled in by one
+        ///        sweep, as for the gen/kill analyses, unless the engine keeps
+        ///        its own solution instead, leaving @c BVs empty (see
+        ///        @c deriveBlockVals ).
+        /// @param F
+        /// @return False if the analysis does not have a sparse engine.
+        virtual bool solveSparse(const llvm::Function &F) { return false; }
+
+        /// @brief Discard the domain and all the solver state, so that the
+        ///        function can be solved from scratch.
+        virtual void reset() {
+            DomainIdMap.clear();
+            DomainVector.clear();
+            InstUseIds.clear();
+            InstDefIds.clear();
+            MemoryIds.clear();
+            BVs.clear();
+            BBOutVals.clear();
+            InstDomainValMap.clear();
+            BBGenKills.clear();
+            MaterializedBBs.clear();
+            Traversal = {};
+            SparseSolutionOnly = false;
+            releaseCachedResult();
+        }
+
+        /// @brief Build the domain of @p F and solve the analysis over it, or
+        ///        load the results from the cache, in which case the domain is
+        ///        only built once it is needed (see @c requireDomain ).
+        /// @param F
+        void solve(llvm::Function &F) {
+            SparseSolutionOnly = false;
+            releaseCachedResult();
+            // the rewriting needs the internal state of the solver, and the
+            // summaries are not part of the cache key
+            std::string CachePath;
+            if (!Opts.CacheDir.empty() && !Opts.Transform && Summaries == nullptr) {
+                CachePath = ResultCache::getPath(Opts.CacheDir, getName(), Opts.Lazy, F);
+                if (loadCachedResult(F, CachePath)) {
+                    // (hence there is nothing to update incrementally)
+                    SolvedBBs = SolvedSparse = false;
+                    PendingDomainFunc = &F;
+                    return;
+                }
+            }
+            initDomain(F);
+            solveOverDomain(F, CachePath);
+        }
+
+        /// @brief Bring the solution up to date after local edits of @p F ,
+        ///        which has to have been solved before. Only the elements
+        ///        whose block GEN/KILL sets have changed are re-solved, and only
+        ///        over the blocks that depend on the edited ones.
+        ///
+        ///        The new elements are appended to the domain without resizing
+        ///        the values that do not hold them, whose bits past the end are
+        ///        unset (the values read through @c getValueAt and
+        ///        @c getResult are of the full size). The elements that no
+        ///        longer occur are kept until the domain has doubled since the
+        ///        last solve from scratch, which then drops them.
+        /// @param F
+        /// @param EditedInsts Instructions that have been inserted or modified
+        ///                    (including the users rewritten by RAUW).
+        /// @param EditedBBs Blocks from which instructions have been erased, or
+        ///                  that have otherwise changed. The CFG itself has to
+        ///                  be unchanged.
+        /// @return False if the function has been solved from scratch instead,
+        ///         as it is for the analyses that are not solved over gen/kill
+        ///         summaries, and in lazy and sparse modes.
+        bool update(llvm::Function &F,
+                    llvm::ArrayRef<llvm::Instruction *> EditedInsts,
+                    llvm::ArrayRef<llvm::BasicBlock *> EditedBBs) {
+            if constexpr (std::is_same_v<DomainVal_t, llvm::BitVector>) {
+                if (SolvedBBs && !Opts.Lazy && !SolvedSparse &&
+                    updateGenKill(F, EditedInsts, EditedBBs)) {
+                    return true;
+                }
+            }
+            reset();
+            solve(F);
+            return false;
+        }
+
+        /// @brief Run the fixpoint iteration over the solved @p F once more,
+        ///        from every block, followed by the per-instruction sweep. As
+        ///        the solution is a fixpoint already, nothing changes, and no
+        ///        memory is allocated (e.g., for the solver to be measured in
+        ///        its steady state).
+        ///        The sparse engines that keep their own solution are run again
+        ///        instead.
+        /// @return False if there is nothing to iterate over, as in lazy mode
+        ///         and for cached results.
+        bool reiterate(const llvm::Function &F) {
+            if (SparseSolutionOnly && SolvedSparse) {
+                return solveSparse(F);
+            }
+            if (BBOutVals.empty() || InstDomainValMap.empty()) {
+                return false;
+            }
+            traverseCFG(F);
+            traverseInsts(F);
+            return true;
+        }
+
+        /// @brief Get the domain and the values. The values are empty for the
+        ///        sparse engines that keep their own solution (see
+        ///        @c deriveBlockVals ), and for the results read from the
+        ///        cache, which are only read on demand (see @c getValueAt ),
+        ///        as is their domain.
+        AnalysisResult_t getResult() const {
+            AnalysisResult_t Result =
+                    std::make_tuple(DomainIdMap, DomainVector, BVs, InstDomainValMap);
+            // (the values that predate an update may be shorter)
+            for (auto &BV : std::get<2>(Result)) {
+                BV.second.resize(DomainVector.size());
+            }
+            for (auto &InstVal : std::get<3>(Result)) {
+                InstVal.second.resize(DomainVector.size());
+            }
+            return Result;
+        }
+
+        virtual AnalysisResult_t run(llvm::Function &F,
+                                     llvm::FunctionAnalysisManager &FAM) {
+            const bool Timed = llvm::TimePassesIsEnabled && Opts.TimePhases;
+            const std::string TimerGroup = "dfa-" + getName();
+            {
+                llvm::NamedRegionTimer SolveTimer("solve", "Solve", TimerGroup,
+                                                  "DFA " + getName(), Timed);
+                solve(F);
+            }
+            //// debug output print
+            {
+                llvm::NamedRegionTimer PrintTimer("print", "Print", TimerGroup,
+                                                  "DFA " + getName(), Timed);
+                if (Opts.Output == OutputMode::Dump) {
+                    printInstDomainValMap(F);
+                } else if (Opts.Output == OutputMode::Stream) {
+                    streamResults(F);
+                }
+            }
+            const SolverStats Stats = getSolverStats();
+            recordStatistics(getName(), Stats);
+            if (!Opts.StatsReport.empty()) {
+                appendStatsReport(Opts.StatsReport, getName(), F, Stats);
+            }
+            if (Opts.PrintStats) {
+                LOG_ANALYSIS_INFO << "block visits: " << NumBlockVisits;
+                if (!Opts.CacheDir.empty()) {
+                    // so far in this process
+                    const ResultCache::Stats CacheStats = ResultCache::getStats();
+                    LOG_ANALYSIS_INFO << "cache hits: " << CacheStats.Hits
+                                      << ", misses: " << CacheStats.Misses
+                                      << ", bytes mapped: " << CacheStats.BytesMapped;
+                }
+            }
+            return getResult();
+        }
+
+    private:
+        /// Whether the last solve went over @c BBGenKills , or through the
+        /// sparse engine.
+        bool SolvedBBs = false, SolvedSparse = false;
+        /// Whether the values are derived from the solution of the sparse
+        /// engine (see @c deriveBlockVals ), solved or loaded from the cache.
+        bool SparseSolutionOnly = false;
+        /// Size of the domain built by the last solve from scratch.
+        size_t NumSolvedElems = 0;
+
+        /// The mapped cache file that the values have been read from by the
+        /// last solve, if any, and the size of their domain. (It is shared by
+        /// the copies of the analysis, e.g., by the pass manager.)
+        std::shared_ptr<const llvm::sys::fs::mapped_file_region> CachedRegion;
+        size_t CachedDomainSize = 0;
+        /// Block boundary values, and per-instruction values unless only the
+        /// former are kept, as 32-bit mask words in @c CachedRegion . They
+        /// are only read when queried.
+        llvm::DenseMap<const llvm::BasicBlock *, llvm::ArrayRef<uint32_t>> CachedBVs;
+        llvm::DenseMap<const llvm::Instruction *, llvm::ArrayRef<uint32_t>> CachedInstVals;
+        /// Function whose results have been read from the cache, as long as
+        /// its domain has not been built (see @c requireDomain ).
+        llvm::Function *PendingDomainFunc = nullptr;
+
+        /// @brief Map the cache file at @p Path , and point the views of the
+        ///        values of @p F into it, or set up the solution of the sparse
+        ///        engine from it. Nothing is checked against the domain, which
+        ///        is not built yet.
+        /// @return False if there is no valid file, in which case nothing has
+        ///         been loaded.
+        bool loadCachedResult(const llvm::Function &F, const llvm::StringRef Path) {
+            std::unique_ptr<llvm::sys::fs::mapped_file_region> Region =
+                    ResultCache::map(Path);
+            if (Region == nullptr) {
+                return false;
+            }
+            ResultReader Reader(*Region);
+            ResultCache::Header Hdr{};
+            const size_t NumInsts = F.getInstructionCount();
+            bool Valid = Reader.read(Hdr) && Hdr.Magic == ResultCache::Magic &&
+                         Hdr.Version == ResultCache::Version &&
+                         Hdr.NumBBs == F.size() &&
+                         (Hdr.NumInsts == 0 || Hdr.NumInsts == NumInsts);
+            if (Valid && Hdr.SparseSolution != 0) {
+                SparseSolutionOnly =
+                        derived().readSparseSolution(F, Reader, Hdr.DomainSize);
+                Valid = SparseSolutionOnly;
+            } else if constexpr (std::is_same_v<DomainVal_t, llvm::BitVector>) {
+                const size_t NumWords = (Hdr.DomainSize + 31) / 32;
+                for (const llvm::BasicBlock &BB : F) {
+                    const uint32_t *Words = Valid ? Reader.readWords(NumWords) : nullptr;
+                    Valid = Words != nullptr;
+                    CachedBVs[&BB] = llvm::ArrayRef<uint32_t>(Words, NumWords);
+                }
+                if (Valid && Hdr.NumInsts != 0) {
+                    for (const llvm::Instruction &I : llvm::instructions(&F)) {
+                        const uint32_t *Words = Valid ? Reader.readWords(NumWords) : nullptr;
+                        Valid = Words != nullptr;
+                        CachedInstVals[&I] = llvm::ArrayRef<uint32_t>(Words, NumWords);
+                    }
+                }
+            } else {
+                // (the other values are not cached, see storeCachedResult)
+                Valid = false;
+            }
+            Valid = Valid && Reader.atEnd();
+            ResultCache::count(Valid, Region->size());
+            if (!Valid) {
+                releaseCachedResult();
+                SparseSolutionOnly = false;
+                return false;
+            }
+            CachedRegion = std::move(Region);
+            CachedDomainSize = Hdr.DomainSize;
+            return true;
+        }
+
+        /// @brief Read a value of the cached result from its mask words.
+        llvm::BitVector readCachedVal(const llvm::ArrayRef<uint32_t> Words) const {
+            llvm::BitVector Val(CachedDomainSize);
+            Val.setBitsInMask(Words.data(), Words.size());
+            return Val;
+        }
+
+        void releaseCachedResult() {
+            CachedBVs.clear();
+            CachedInstVals.clear();
+            CachedRegion.reset();
+            PendingDomainFunc = nullptr;
+        }
+
+        void storeCachedResult(const llvm::Function &F, const llvm::StringRef Path) const {
+            ResultWriter Writer;
+            const ResultCache::Header Hdr{
+                    ResultCache::Magic, ResultCache::Version,
+                    static_cast<uint32_t>(DomainVector.size()),
+                    static_cast<uint32_t>(F.size()),
+                    // lazy mode
+                    InstDomainValMap.empty() ? 0 : F.getInstructionCount(),
+                    SparseSolutionOnly};
+            Writer.write(Hdr);
+            if (SparseSolutionOnly) {
+                derived().writeSparseSolution(F, Writer);
+                ResultCache::store(Path, Writer.getBytes());
+                return;
+            }
+            // only bit vectors are read back in place
+            if constexpr (!std::is_same_v<DomainVal_t, llvm::BitVector>) {
+                return;
+            }
+            for (const llvm::BasicBlock &BB : F) {
+                writeDomainVal(Writer, BVs.at(&BB));
+            }
+            if (!InstDomainValMap.empty()) {
+                for (const llvm::Instruction &I : llvm::instructions(&F)) {
+                    writeDomainVal(Writer, InstDomainValMap.at(&I));
+                }
+            }
+            ResultCache::store(Path, Writer.getBytes());
+        }
+
+        /// @brief Bring the per-instruction values of the elements @p Ids up
+        ///        to date over @p BB , from its boundary value, without going
+        ///        through whole values (see @c getGenKillIds ).
+        /// @param Mask The elements of @p Ids .
+        /// @param Cur Scratch value, of the size of the domain.
+        /// @return False if the analysis does not give its GEN/KILL sets as
+        ///         ids, in which case nothing has been updated.
+        template<typename TVal = DomainVal_t>
+        bool traverseInsts(const llvm::BasicBlock &BB, llvm::ArrayRef<unsigned> Ids,
+                           const DomainVal_t &Mask, DomainVal_t &Cur) {
+            const DomainVal_t &BV = BVs.at(&BB);
+            for (const unsigned Id : Ids) {
+                Cur[Id] = Id < BV.size() && BV.test(Id);
+            }
+            llvm::ArrayRef<unsigned> GenIds, KillIds;
+            for (const llvm::Instruction &I : derived().getInstConstRange(BB)) {
+                if (!derived().getGenKillIds(I, GenIds, KillIds)) {
+                    return false;
+                }
+                for (const unsigned Id : KillIds) {
+                    if (Mask.test(Id)) {
+                        Cur.reset(Id);
+                    }
+                }
+                for (const unsigned Id : GenIds) {
+                    if (Mask.test(Id)) {
+                        Cur.set(Id);
+                    }
+                }
+                DomainVal_t &ODV = InstDomainValMap[&I];
+                ++NumTransferCalls;
+                for (const unsigned Id : Ids) {
+                    if (Id < ODV.size()) {
+                        ODV[Id] = Cur.test(Id);
+                    } else if (Cur.test(Id)) {
+                        ODV.resize(DomainVector.size());
+                        ODV.set(Id);
+                    }
+                }
+            }
+            return true;
+        }
+
+        /// @brief Incremental part of @c update , a template so that it is
+        ///        only instantiated for bit-vector values.
+        /// @return False if the domain has doubled, in which case nothing has
+        ///         been updated.
+        template<typename TVal = DomainVal_t>
+        bool updateGenKill(llvm::Function &F,
+                           llvm::ArrayRef<llvm::Instruction *> EditedInsts,
+                           llvm::ArrayRef<llvm::BasicBlock *> EditedBBs) {
+            std::unordered_set<llvm::BasicBlock *> Edited(EditedBBs.begin(),
+                                                          EditedBBs.end());
+            for (llvm::Instruction *I : EditedInsts) {
+                Edited.insert(I->getParent());
+            }
+            // re-intern the elements of the edited blocks, new ones are appended
+            // and the ones that no longer occur are left as (never set) ids
+            Initializer initializer(DomainIdMap, DomainVector, InstUseIds);
+            for (llvm::BasicBlock *BB : Edited) {
+                for (llvm::Instruction &I : *BB) {
+                    InstUseIds.insert(&I, {});
+                    initializer.visit(I);
+                }
+            }
+            if (DomainVector.size() > 2 * NumSolvedElems) {
+                return false;
+            }
+            const size_t NumMemoryIds = MemoryIds.size();
+            initMemoryIds();
+            // the definitions of the operands depend on their users
+            std::unordered_set<const llvm::BasicBlock *> SummaryBBs(Edited.begin(),
+                                                                   Edited.end());
+            for (llvm::BasicBlock *BB : Edited) {
+                for (llvm::Instruction &I : *BB) {
+                    initInstDefIds(I);
+                    for (const llvm::Value *Op : I.operands()) {
+                        if (const auto *OpInst = llvm::dyn_cast<llvm::Instruction>(Op)) {
+                            initInstDefIds(*OpInst);
+                            SummaryBBs.insert(OpInst->getParent());
+                        }
+                    }
+                }
+            }
+            // the elements newly read from memory may be killed anywhere
+            if (MemoryIds.size() != NumMemoryIds) {
+                for (const llvm::Instruction &I : llvm::instructions(F)) {
+                    if (I.mayWriteToMemory()) {
+                        initInstDefIds(I);
+                        SummaryBBs.insert(I.getParent());
+                    }
+                }
+            }
+            // only the elements whose GEN/KILL have changed in some block have
+            // to be re-solved
+            DomainVal_t Changed = bc();
+            std::vector<const llvm::BasicBlock *> Worklist;
+            for (const llvm::BasicBlock *BB : SummaryBBs) {
+                GenKill_t Old = std::move(BBGenKills.at(BB));
+                initBBGenKill(*BB);
+                const GenKill_t &New = BBGenKills.at(BB);
+                DomainVal_t Diff = Old.Gen;
+                Diff ^= New.Gen;
+                Changed |= Diff;
+                Diff = Old.Kill;
+                Diff ^= New.Kill;
+                Changed |= Diff;
+                if (!(sameElems(Old.Gen, New.Gen) && sameElems(Old.Kill, New.Kill))) {
+                    Worklist.push_back(BB);
+                }
+            }
+            std::unordered_set<const llvm::BasicBlock *> Region(Worklist.begin(),
+                                                               Worklist.end());
+            while (!Worklist.empty()) {
+                const llvm::BasicBlock *BB = Worklist.back();
+                Worklist.pop_back();
+                for (const llvm::BasicBlock *Dep :
+                        derived().getDependentBBConstRange(*BB)) {
+                    if (Region.insert(Dep).second) {
+                        Worklist.push_back(Dep);
+                    }
+                }
+            }
+            // restart these elements from the initial value over the region
+            DomainVal_t Init = derived().initVal();
+            Init &= Changed;
+            for (const llvm::BasicBlock *BB : Region) {
+                DomainVal_t &OutVal = BBOutVals.at(BB);
+                OutVal.reset(Changed);
+                OutVal |= Init;
+            }
+            if (!Region.empty()) {
+                traverseCFG(F, &Region);
+            }
+            // the instructions of the summarized blocks are replayed whole, as
+            // their GEN/KILL sets may have changed in any element; elsewhere in
+            // the region, only the re-solved elements have changed, unless
+            // there are so many that whole values are as cheap (the entries of
+            // the erased instructions are left behind, they are never looked up
+            // again)
+            std::vector<unsigned> ChangedIds;
+            for (const unsigned Id : Changed.set_bits()) {
+                ChangedIds.push_back(Id);
+            }
+            bool ById = ChangedIds.size() < (Changed.size() + 63) / 64;
+            DomainVal_t Cur = bc();
+            for (const llvm::BasicBlock &BB : F) {
+                if (SummaryBBs.count(&BB) != 0) {
+                    traverseInsts(BB);
+                } else if (Region.count(&BB) != 0) {
+                    ById = ById && traverseInsts(BB, ChangedIds, Changed, Cur);
+                    if (!ById) {
+                        traverseInsts(BB);
+                    }
+                }
+            }
+            return true;
+        }
+
+    }; // class Framework
+
+    /// @brief For each domain element type, we have to define:
+    ///        - The default constructor
+    ///        - The meet operators (for intersect/union)
+    ///        - The top element
+    ///        - Conversion to bool (for logging)
+    struct Bool {
+        bool Value = false;
+
+        Bool operator&(const Bool &Other) const {
+            return {.Value = Value && Other.Value};
+        }
+
+        Bool operator|(const Bool &Other) const {
+            return {.Value = Value || Other.Value};
+        }
+
+        bool operator==(const Bool &Other) const { return Value == Other.Value; }
+
+        static Bool top() { return {.Value = true }; }
+
+        explicit operator bool() const { return Value; }
+    };
+
+    /// @brief For each domain element type, we have to define:
+    ///        - The default constructor
+    ///        - The meet operators (for intersect/union)
+    ///        - The top element
+    ///        - Conversion to bool (for logging)
+    struct Lattice {
+        // (Top Element) => not defined
+        enum LatticeElement {
+            undef,
+            overdef,
+            constant
+        };
+        /// The constant is held inline (no allocation up to 64 bits), and only
+        /// materialized as a @c ConstantInt when reported (see @c toConstant ),
+        /// so that the analysis does not grow the context.
+        llvm::APInt Constant;
+        LatticeElement state = LatticeElement::undef;
+
+        void markOverdef() {
+            state = LatticeElement::overdef;
+            Constant = llvm::APInt();
+        }
+
+        void markConstant(const llvm::APInt &c) {
+            state = LatticeElement::constant;
+            Constant = c;
+        }
+
+        bool isConstant() const {
+            return LatticeElement::constant == state;
+        }
+
+        bool isOverdef() const {
+            return LatticeElement::overdef == state;
+        }
+
+        bool isUndef() const {
+            return LatticeElement::undef == state;
+        }
+
+        llvm::ConstantInt *toConstant(llvm::LLVMContext &context) const {
+            assert(isConstant());
+            return llvm::ConstantInt::get(context, Constant);
+        }
+
+        Lattice operator&(const Lattice &Other) const {
+            Lattice currentCopy = *this;
+            if (Other.state == LatticeElement::undef) {
+                return currentCopy;
+            } else if (Other.state == LatticeElement::overdef || state == LatticeElement::overdef) {
+                currentCopy.markOverdef();
+                return currentCopy;
+            } else if (state == LatticeElement::undef) {
+                Lattice otherCopy = Other;
+                return otherCopy;
+            }
+            // both state should be constant
+            assert(state == LatticeElement::constant && Other.state == LatticeElement::constant);
+            if (!sameConstant(Other)) {
+                // if value is not the same get
+                currentCopy.markOverdef();
+            }
+            return currentCopy;
+        }
+
+        static Lattice top() { return Lattice(); }
+
+
+        bool operator==(const Lattice &Other) const  {
+            if (state == LatticeElement::constant && Other.state == LatticeElement::constant) {
+                return sameConstant(Other);
+            }
+            return state == Other.state;
+        }
+
+        explicit operator bool() const { return state == LatticeElement::constant; }
+
+    private:
+        bool sameConstant(const Lattice &Other) const {
+            return Constant.getBitWidth() == Other.Constant.getBitWidth() &&
+                   Constant == Other.Constant;
+        }
+    };
+
+    /// Lattice values are stored cell by cell, as the state, followed by the
+    /// bit width and words of the constants.
+    inline void writeDomainVal(ResultWriter &Writer, const std::vector<Lattice> &Val) {
+        for (const Lattice &Cell : Val) {
+            Writer.write(static_cast<uint32_t>(Cell.state));
+            if (Cell.isConstant()) {
+                Writer.write(Cell.Constant.getBitWidth());
+                for (unsigned Idx = 0; Idx < Cell.Constant.getNumWords(); ++Idx) {
+                    Writer.write(Cell.Constant.getRawData()[Idx]);
+                }
+            }
+        }
+    }
+
+    /// Only the constant cells are written, as @c id=value .
+    inline void streamDomainVal(llvm::raw_ostream &Outs, const std::vector<Lattice> &Val) {
+        for (size_t Id = 0; Id < Val.size(); ++Id) {
+            if (Val[Id].isConstant()) {
+                Outs << ' ' << Id << '=';
+                // (booleans as 0 and 1)
+                Val[Id].Constant.print(Outs, Val[Id].Constant.getBitWidth() > 1);
+            }
+        }
+    }
+
+    inline size_t getDomainValBytes(const std::vector<Lattice> &Val) {
+        size_t Bytes = Val.capacity() * sizeof(Lattice);
+        for (const Lattice &Cell : Val) {
+            if (!Cell.Constant.isSingleWord()) {
+                Bytes += Cell.Constant.getNumWords() * sizeof(uint64_t);
+            }
+        }
+        return Bytes;
+    }
+
+    inline bool readDomainVal(ResultReader &Reader, std::vector<Lattice> &Val,
+                              const size_t DomainSize) {
+        Val.assign(DomainSize, Lattice());
+        for (Lattice &Cell : Val) {
+            uint32_t State = 0, BitWidth = 0;
+            if (!Reader.read(State)) {
+                return false;
+            }
+            if (State == Lattice::overdef) {
+                Cell.markOverdef();
+            } else if (State == Lattice::constant) {
+                if (!Reader.read(BitWidth) || BitWidth == 0) {
+                    return false;
+                }
+                llvm::SmallVector<uint64_t, 2> Words(llvm::APInt::getNumWords(BitWidth));
+                for (uint64_t &Word : Words) {
+                    if (!Reader.read(Word)) {
+                        return false;
+                    }
+                }
+                Cell.markConstant(llvm::APInt(BitWidth, Words));
+            } else if (State != Lattice::undef) {
+                return false;
+            }
+        }
+        return true;
+    }
+
 } // namespace dfa
\ No newline at end of file
@@ -0,0 +1,122 @@
+#pragma once // NOLINT(llvm-header-guard)
+
+#include <llvm/ADT/BitVector.h>
+#include <llvm/ADT/StringRef.h>
+#include <llvm/IR/Function.h>
+#include <llvm/Support/FileSystem.h>
+
+#include <cstring>
+#include <memory>
+#include <string>
+#include <type_traits>
+
+namespace dfa {
+
+    /// @brief Serialized analysis results, kept in a directory with one file
+    ///        per (analysis, function), named after a hash of the function.
+    ///        The files are memory-mapped when read back, and the values are
+    ///        read in place as they are queried.
+    ///
+    ///        Layout: a header of 32-bit fields, then the boundary value of
+    ///        every block and, unless only those are kept (lazy mode), the
+    ///        value of every instruction, all in function order, or else the
+    ///        solution of a sparse engine that keeps no block values (see
+    ///        @c Framework::deriveBlockVals ). Domain values refer to the
+    ///        elements by id, which the domain initializer assigns
+    ///        deterministically, so that only the values have to be stored.
+    class ResultCache {
+    public:
+        /// Counters of the current process, over all the analyses.
+        struct Stats {
+            size_t Hits, Misses, BytesMapped;
+        };
+
+        struct Header {
+            uint32_t Magic, Version, DomainSize, NumBBs, NumInsts, SparseSolution;
+        };
+        static constexpr uint32_t Magic = 0x43414644; // "DFAC"
+        /// (bumped whenever the meaning of the domain ids changes, e.g., when
+        /// the expression domain was extended past the binary operators)
+        static constexpr uint32_t Version = 3;
+
+        /// @brief Get the path of the cached results of @p AnalysisName over
+        ///        @p F , whose key is a hash of the structure of the function
+        ///        (and of whether only the block boundary values are kept),
+        ///        computed without printing it.
+        static std::string getPath(llvm::StringRef Dir, llvm::StringRef AnalysisName,
+                                   bool Lazy, const llvm::Function &F);
+
+        /// @brief Map the file at @p Path , or return null (and count a miss)
+        ///        if there is none.
+        static std::unique_ptr<llvm::sys::fs::mapped_file_region>
+        map(llvm::StringRef Path);
+
+        /// @brief Write @p Bytes to @p Path through a temporary file, so that
+        ///        concurrent readers never see a partial file.
+        static void store(llvm::StringRef Path, llvm::StringRef Bytes);
+
+        /// @brief Count a hit of @p Bytes mapped bytes, or a miss if the mapped
+        ///        file turned out not to be valid.
+        static void count(bool Hit, size_t Bytes);
+
+        static Stats getStats();
+    };
+
+    /// @brief Append the fields of a cached result.
+    class ResultWriter {
+        std::string Bytes;
+
+    public:
+        template<typename T>
+        void write(const T &Val) {
+            static_assert(std::is_trivially_copyable_v<T> && sizeof(T) % 4 == 0,
+                          "fields are kept 32-bit aligned");
+            Bytes.append(reinterpret_cast<const char *>(&Val), sizeof(T));
+        }
+
+        llvm::StringRef getBytes() const { return Bytes; }
+    };
+
+    /// @brief Read the fields of a cached result from a mapped file.
+    class ResultReader {
+        const char *Cur, *const End;
+
+    public:
+        explicit ResultReader(const llvm::sys::fs::mapped_file_region &Region)
+                : Cur(Region.const_data()), End(Region.const_data() + Region.size()) {}
+
+        template<typename T>
+        bool read(T &Val) {
+            if (static_cast<size_t>(End - Cur) < sizeof(T)) {
+                return false;
+            }
+            std::memcpy(&Val, Cur, sizeof(T));
+            Cur += sizeof(T);
+            return true;
+        }
+
+        /// @brief Get @p NumWords words in place, null if past the end.
+        const uint32_t *readWords(size_t NumWords) {
+            if (static_cast<size_t>(End - Cur) < NumWords * sizeof(uint32_t)) {
+                return nullptr;
+            }
+            const auto *Words = reinterpret_cast<const uint32_t *>(Cur);
+            Cur += NumWords * sizeof(uint32_t);
+            return Words;
+        }
+
+        bool atEnd() const { return Cur == End; }
+    };
+
+    /// Bit-vector values are stored as their 32-bit mask words.
+    inline void writeDomainVal(ResultWriter &Writer, const llvm::BitVector &Val) {
+        std::vector<uint32_t> Words((Val.size() + 31) / 32);
+        for (const unsigned Bit : Val.set_bits()) {
+            Words[Bit / 32] |= 1U << (Bit % 32);
+        }
+        for (const uint32_t Word : Words) {
+            Writer.write(Word);
+        }
+    }
+
+} // namespace dfa
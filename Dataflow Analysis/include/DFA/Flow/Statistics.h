@@ -0,0 +1,34 @@
+#pragma once // NOLINT(llvm-header-guard)
+
+#include <llvm/ADT/StringRef.h>
+#include <llvm/IR/Function.h>
+
+#include <cstddef>
+
+namespace dfa {
+
+    /// @brief Counters of an analysis over one function.
+    struct SolverStats {
+        /// Iterations over the components of the weak topological ordering
+        /// of the dense solver, counting the whole function as one (for the
+        /// round-robin LCM solver, its sweeps over the blocks).
+        size_t Rounds = 0;
+        size_t BlockVisits = 0;
+        size_t TransferCalls = 0;
+        /// Applications of the meet operator (to two operands).
+        size_t Meets = 0;
+        size_t DomainSize = 0;
+        /// Bytes held by the block boundary and per-instruction values.
+        size_t BytesHeld = 0;
+    };
+
+    /// @brief Add @p Stats to the counters of @p AnalysisName reported by
+    ///        @c -stats .
+    void recordStatistics(llvm::StringRef AnalysisName, const SolverStats &Stats);
+
+    /// @brief Append @p Stats as a JSON object, on a line of its own, to the
+    ///        report at @p Path .
+    void appendStatsReport(llvm::StringRef Path, llvm::StringRef AnalysisName,
+                           const llvm::Function &F, const SolverStats &Stats);
+
+} // namespace dfa
@@ -0,0 +1,77 @@
+#pragma once // NOLINT(llvm-header-guard)
+
+#include "DFA/Flow/Framework.h"
+
+#include <llvm/ADT/BitVector.h>
+#include <llvm/IR/Function.h>
+#include <llvm/IR/InstrTypes.h>
+#include <llvm/IR/Module.h>
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace dfa {
+
+    /// @brief What a function and its callers know of each other.
+    struct FunctionSummary {
+        /// Lattice value of every argument, i.e., the meet over the executable
+        /// call sites. Overdefined unless all the call sites are known.
+        std::vector<Lattice> Args;
+        /// Lattice value of the returned value, i.e., the meet over the
+        /// executable returns.
+        Lattice Return;
+        /// Whether the value of each argument may be needed, by the function
+        /// itself or by a callee it is passed to.
+        llvm::BitVector LiveArgs;
+        /// Whether every call site of the function is known, i.e., it is local
+        /// to the module and only ever called directly, with its own type.
+        bool KnownCallSites = false;
+        /// Lattice values of the arguments at the executable call sites of the
+        /// function, into the callees whose call sites are all known.
+        std::unordered_map<const llvm::CallBase *, std::vector<Lattice>> CallSiteArgs;
+    };
+
+    /// @brief Summaries of all the functions defined in a module, which start
+    ///        out conservative (i.e., every argument and returned value is
+    ///        overdefined, and every argument is live).
+    ///
+    ///        The table itself is only built once, so that the summaries of
+    ///        different functions can be solved concurrently, as long as those
+    ///        of a function are not read while they are being written (see
+    ///        @c DFAInterprocPass ).
+    class ModuleSummaries {
+    private:
+        std::unordered_map<const llvm::Function *, FunctionSummary> Summaries;
+
+    public:
+        explicit ModuleSummaries(const llvm::Module &M);
+
+        /// @return The summary of @p F , or null if it is not defined.
+        FunctionSummary *lookup(const llvm::Function &F);
+        const FunctionSummary *lookup(const llvm::Function &F) const;
+
+        /// @brief Get the function that @p Call calls, if its summary applies,
+        ///        i.e., it is called directly, with its own type, and its
+        ///        definition cannot be replaced at link time.
+        /// @return The callee, or null if it has no summary.
+        const llvm::Function *getSummarizedCallee(const llvm::CallBase &Call) const;
+
+        /// @brief Get the lattice value of @p Arg on entry to its function.
+        Lattice getArg(const llvm::Argument &Arg) const;
+        /// @brief Get the lattice value of the result of @p Call .
+        Lattice getReturn(const llvm::CallBase &Call) const;
+        /// @brief Check whether the value passed as argument @p ArgNo of
+        ///        @p Call may be needed by the callee.
+        bool isArgLive(const llvm::CallBase &Call, unsigned ArgNo) const;
+
+        /// @brief Print the summary of @p F , as
+        ///
+        ///            @f(i32 %x = 3, i32 %y (dead)) -> 9
+        ///
+        ///        i.e., the constant arguments, the dead arguments and the
+        ///        constant returned value.
+        std::string stringify(const llvm::Function &F) const;
+    };
+
+} // namespace dfa
@@ -1,71 +1,134 @@
-#pragma once // NOLINT(llvm-header-guard)
-
-#include <vector>
-
-namespace dfa {
-
-    template<typename TValue>
-    struct MeetOpBase {
-        using DomainVal_t = std::vector<TValue>;
-
-        /// @brief Apply the meet operator using two operands.
-        /// @param LHS
-        /// @param RHS
-        /// @return
-        virtual DomainVal_t operator()(const DomainVal_t &LHS,
-                                       const DomainVal_t &RHS) const = 0;
-
-        /// @brief Return a domain value that represents the top element, used when
-        ///        doing the initialization.
-        /// @param DomainSize
-        /// @return
-        virtual DomainVal_t top(const std::size_t DomainSize) const = 0;
-    };
-
-    template<typename TValue>
-    struct Intersect final : MeetOpBase<TValue> {
-        using DomainVal_t = typename MeetOpBase<TValue>::DomainVal_t;
-
-        DomainVal_t operator()(const DomainVal_t &LHS,
-                               const DomainVal_t &RHS) const final {
-            /// get the intersect of the two results by & both sets
-            using llvm::outs;
-            DomainVal_t result;
-            for (int i = 0; i < LHS.size(); i++) {
-                result.push_back(LHS[i] & RHS[i]);
-            }
-            return result;
-        }
-
-        DomainVal_t top(const std::size_t DomainSize) const final {
-            /// the top of intersect operator is just the empty set with all false
-            DomainVal_t EmptySet(DomainSize);
-            return EmptySet;
-        }
-    };
-
-/// @todo(CSCD70) Please add another subclass for the Union meet operator.
-    template<typename TValue>
-    struct Union final : MeetOpBase<TValue> {
-        using DomainVal_t = typename MeetOpBase<TValue>::DomainVal_t;
-
-        DomainVal_t operator()(const DomainVal_t &LHS,
-                               const DomainVal_t &RHS) const final {
-            /// get the intersect of the two results by & both sets
-            DomainVal_t result;
-            for (size_t i = 0; i < LHS.size(); i++) {
-                result.push_back(LHS[i] | RHS[i]);
-            }
-            return result;
-        }
-
-        DomainVal_t top(const std::size_t DomainSize) const final {
-            /// the top of union operator is the entire domain
-            DomainVal_t Domain(DomainSize);
-            for (size_t i = 0; i < DomainSize; i++) {
-                Domain[i] = TValue::top();
-            }
-            return Domain;
-        }
-    };
-} // namespace dfa
+#pragma once // NOLINT(llvm-header-guard)
+
+#include <llvm/ADT/BitVector.h>
+
+#include <vector>
+
+namespace dfa {
+
+    /// @brief Storage of a domain value, i.e., one @c TValue per domain element.
+    template<typename TValue>
+    struct DomainValStorage {
+        using type = std::vector<TValue>;
+    };
+
+    struct Bool;
+
+    /// @brief Boolean domain values are packed into 64-bit words (one bit per
+    ///        domain element), so that the meet operators, the gen/kill
+    ///        transfer and the change check become word-wide loops.
+    template<>
+    struct DomainValStorage<Bool> {
+        using type = llvm::BitVector;
+    };
+
+    /// @brief Common base of the meet operators, which are passed to the
+    ///        framework as a template parameter and called directly. Each
+    ///        provides:
+    ///
+    ///        - @c meetInto(Acc,Other) , which applies the meet operator to
+    ///          @c Acc in place, so that no value is allocated once @c Acc is
+    ///          sized (this is what the solver uses),
+    ///        - @c operator()(LHS,RHS) , which applies the meet operator using
+    ///          two operands, and
+    ///        - @c top(DomainSize) , which returns a domain value that
+    ///          represents the top element, used when doing the initialization.
+    template<typename TValue>
+    struct MeetOpBase {
+        using DomainVal_t = typename DomainValStorage<TValue>::type;
+    };
+
+    template<typename TValue>
+    struct Intersect final : MeetOpBase<TValue> {
+        using DomainVal_t = typename MeetOpBase<TValue>::DomainVal_t;
+
+        void meetInto(DomainVal_t &Acc, const DomainVal_t &Other) const {
+            /// get the intersect of the two results by & both sets
+            for (size_t i = 0; i < Acc.size(); i++) {
+                Acc[i] = Acc[i] & Other[i];
+            }
+        }
+
+        DomainVal_t operator()(const DomainVal_t &LHS,
+                               const DomainVal_t &RHS) const {
+            DomainVal_t result = LHS;
+            meetInto(result, RHS);
+            return result;
+        }
+
+        DomainVal_t top(const std::size_t DomainSize) const {
+            /// the top of intersect operator is just the empty set with all false
+            DomainVal_t EmptySet(DomainSize);
+            return EmptySet;
+        }
+    };
+
+    template<>
+    struct Intersect<Bool> final : MeetOpBase<Bool> {
+        using DomainVal_t = typename MeetOpBase<Bool>::DomainVal_t;
+
+        void meetInto(DomainVal_t &Acc, const DomainVal_t &Other) const {
+            Acc &= Other;
+        }
+
+        DomainVal_t operator()(const DomainVal_t &LHS,
+                               const DomainVal_t &RHS) const {
+            DomainVal_t Result = LHS;
+            Result &= RHS;
+            return Result;
+        }
+
+        DomainVal_t top(const std::size_t DomainSize) const {
+            return DomainVal_t(DomainSize);
+        }
+    };
+
+/// @todo(CSCD70) Please add another subclass for the Union meet operator.
+    template<typename TValue>
+    struct Union final : MeetOpBase<TValue> {
+        using DomainVal_t = typename MeetOpBase<TValue>::DomainVal_t;
+
+        void meetInto(DomainVal_t &Acc, const DomainVal_t &Other) const {
+            /// get the union of the two results by | both sets
+            for (size_t i = 0; i < Acc.size(); i++) {
+                Acc[i] = Acc[i] | Other[i];
+            }
+        }
+
+        DomainVal_t operator()(const DomainVal_t &LHS,
+                               const DomainVal_t &RHS) const {
+            DomainVal_t result = LHS;
+            meetInto(result, RHS);
+            return result;
+        }
+
+        DomainVal_t top(const std::size_t DomainSize) const {
+            /// the top of union operator is the entire domain
+            DomainVal_t Domain(DomainSize);
+            for (size_t i = 0; i < DomainSize; i++) {
+                Domain[i] = TValue::top();
+            }
+            return Domain;
+        }
+    };
+
+    template<>
+    struct Union<Bool> final : MeetOpBase<Bool> {
+        using DomainVal_t = typename MeetOpBase<Bool>::DomainVal_t;
+
+        void meetInto(DomainVal_t &Acc, const DomainVal_t &Other) const {
+            Acc |= Other;
+        }
+
+        DomainVal_t operator()(const DomainVal_t &LHS,
+                               const DomainVal_t &RHS) const {
+            DomainVal_t Result = LHS;
+            Result |= RHS;
+            return Result;
+        }
+
+        DomainVal_t top(const std::size_t DomainSize) const {
+            return DomainVal_t(DomainSize, true);
+        }
+    };
+} // namespace dfa
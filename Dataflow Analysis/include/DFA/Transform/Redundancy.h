@@ -0,0 +1,26 @@
+#pragma once // NOLINT(llvm-header-guard)
+
+#include <llvm/ADT/ArrayRef.h>
+#include <llvm/ADT/Twine.h>
+#include <llvm/IR/Instruction.h>
+
+namespace dfa {
+
+    /// @brief Replace the redundant evaluations of an expression with the
+    ///        values that reach them, and erase them, which is the rewriting
+    ///        shared by @c avail-expr-cse and @c lcm .
+    ///
+    ///        @p Avail are the instructions that compute the expression, in
+    ///        the order of their blocks, so that the last one of a block is
+    ///        its value at the end. They may include the evaluations of
+    ///        @p Redundant , which are then replaced in turn. An evaluation
+    ///        takes the value computed earlier in its block if any, otherwise
+    ///        the one that flows in from the predecessors, through new PHI
+    ///        nodes named @p Name where several meet. The values that
+    ///        replace an evaluation only keep the flags (e.g., nsw) and the
+    ///        metadata (e.g., !range) that also hold for it.
+    void replaceRedundant(llvm::ArrayRef<llvm::Instruction *> Avail,
+                          llvm::ArrayRef<llvm::Instruction *> Redundant,
+                          const llvm::Twine &Name);
+
+} // namespace dfa
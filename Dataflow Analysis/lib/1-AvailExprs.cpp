@@ -1,48 +1,101 @@
-#include "DFA.h"
-#include <iostream>
-#include <llvm/IR/IRBuilder.h>
-
-using namespace llvm;
-
-AnalysisKey AvailExprs::Key;
-
-bool AvailExprs::transferFunc(const Instruction &Inst, const DomainVal_t &IDV,
-                              DomainVal_t &ODV) {
-    // A instruction generates expression 𝑥 ⊕ 𝑦 if it definitely evaluates 𝑥 ⊕ 𝑦
-    DomainVal_t gen(DomainVector.size());
-    const Instruction *instr = &Inst;
-    if (instr != nullptr && isa<BinaryOperator>(instr)) {
-        const BinaryOperator *binOp = dyn_cast<BinaryOperator>(instr);
-        dfa::Expression expr = dfa::Expression(*binOp);
-        auto it = std::find(DomainVector.begin(), DomainVector.end(), expr);
-        if (it != DomainVector.end()) {
-            size_t index = std::distance(DomainVector.begin(), it);
-            gen[index] = {.Value = true};
-        }
-    }
-    // For the available expressions dataflow analysis we say that a block
-    // kills expression 𝑥 ⊕ 𝑦 if it assigns (or may assign) 𝑥 or 𝑦
-    DomainVal_t killset = IDV;
-    for (size_t DomainId = 0; DomainId < DomainVector.size(); ++DomainId) {
-        if (!static_cast<bool>(IDV[DomainId])) {
-            continue;
-        }
-        // kill all Input domain value that contains current instruction
-        if (DomainVector[DomainId].contain(instr)) {
-            killset[DomainId] = {.Value = false};
-        }
-    }
-    // gen𝐵 ∪ (𝑥 − kill𝐵)
-    for (size_t DomainId = 0; DomainId < ODV.size(); ++DomainId) {
-        ODV[DomainId] = gen[DomainId] | killset[DomainId];
-    }
-    DomainVal_t prevOutput = InstDomainValMap.at(instr);
-    // compare previous and current output
-    for (size_t DomainId = 0; DomainId < prevOutput.size(); ++DomainId) {
-        if (prevOutput[DomainId].Value != ODV[DomainId].Value) {
-            return true;
-        }
-    }
-    return false;
-}
-
+#include "DFA.h"
+#include <DFA/Transform/Redundancy.h>
+#include <iostream>
+#include <llvm/IR/Dominators.h>
+
+using namespace llvm;
+
+AnalysisKey AvailExprs::Key;
+
+template class dfa::Framework<
+        AvailExprs, dfa::Expression, dfa::Bool, dfa::Intersect<dfa::Bool>,
+        dfa::ForwardMeetBBConstRange_t, dfa::ForwardDependentBBConstRange_t,
+        dfa::ForwardBBConstRange_t, dfa::ForwardInstConstRange_t>;
+template class dfa::ForwardAnalysis<AvailExprs, dfa::Expression, dfa::Bool, dfa::Intersect<dfa::Bool>>;
+
+bool AvailExprs::initGenKill(const Instruction &Inst, DomainVal_t &Gen,
+                             DomainVal_t &Kill) {
+    // A instruction generates expression 𝑥 ⊕ 𝑦 if it definitely evaluates 𝑥 ⊕ 𝑦
+    for (const unsigned DomainId : InstUseIds.lookup(&Inst)) {
+        Gen.set(DomainId);
+    }
+    // For the available expressions dataflow analysis we say that a block
+    // kills expression 𝑥 ⊕ 𝑦 if it assigns (or may assign) 𝑥 or 𝑦
+    for (const unsigned DomainId : InstDefIds.lookup(&Inst)) {
+        Kill.set(DomainId);
+    }
+    return true;
+}
+
+bool AvailExprs::getGenKillIds(const Instruction &Inst,
+                               ArrayRef<unsigned> &GenIds,
+                               ArrayRef<unsigned> &KillIds) {
+    GenIds = InstUseIds.lookup(&Inst);
+    KillIds = InstDefIds.lookup(&Inst);
+    return true;
+}
+
+size_t AvailExprs::rewrite(Function &F) {
+    const DominatorTree DT(F);
+    // the evaluations of every expression, in block order, and those that are
+    // redundant, i.e., evaluated after the expression is available
+    std::vector<SmallVector<Instruction *, 4>> Evals(DomainVector.size()),
+            Redundant(DomainVector.size());
+    DomainVal_t Val;
+    for (BasicBlock &BB : F) {
+        // (everything is available in the blocks that are never reached)
+        if (!DT.isReachableFromEntry(&BB)) {
+            continue;
+        }
+        // replay the block from its boundary value, which also holds in lazy
+        // mode
+        Val = BVs.at(&BB);
+        for (Instruction &Inst : BB) {
+            for (const unsigned DomainId : InstUseIds.lookup(&Inst)) {
+                Evals[DomainId].push_back(&Inst);
+                if (Val.test(DomainId)) {
+                    Redundant[DomainId].push_back(&Inst);
+                }
+            }
+            for (const unsigned DomainId : InstDefIds.lookup(&Inst)) {
+                Val.reset(DomainId);
+            }
+            for (const unsigned DomainId : InstUseIds.lookup(&Inst)) {
+                Val.set(DomainId);
+            }
+        }
+    }
+
+    size_t NumErased = 0;
+    for (size_t DomainId = 0; DomainId < DomainVector.size(); ++DomainId) {
+        if (Redundant[DomainId].empty()) {
+            continue;
+        }
+        const SmallVector<Instruction *, 4> &ExprEvals = Evals[DomainId];
+        dfa::replaceRedundant(ExprEvals, Redundant[DomainId],
+                              ExprEvals.front()->getName() + ".cse");
+        NumErased += Redundant[DomainId].size();
+    }
+    return NumErased;
+}
+
+PreservedAnalyses AvailExprsCSEPass::run(Function &F,
+                                         FunctionAnalysisManager &FAM) {
+    // the rewriting needs the internal state of the solver, and prints
+    // nothing but its own report
+    dfa::Options CSEOpts = Opts;
+    CSEOpts.Transform = true;
+    AvailExprs Analysis(CSEOpts);
+    Analysis.solve(F);
+    const size_t NumErased = Analysis.rewrite(F);
+    if (Opts.Output != dfa::OutputMode::Quiet) {
+        LOG_ANALYSIS_INFO << "@" << F.getName() << ": " << NumErased
+                          << " instructions removed";
+    }
+    if (NumErased == 0) {
+        return PreservedAnalyses::all();
+    }
+    PreservedAnalyses PA;
+    PA.preserveSet<CFGAnalyses>();
+    return PA;
+}
@@ -1,57 +1,317 @@
-#include "DFA.h"
-#include <iostream>
-#include <llvm/IR/IRBuilder.h>
-
-using namespace llvm;
-
-AnalysisKey Liveness::Key;
-
-bool Liveness::transferFunc(const Instruction &Inst, const DomainVal_t &IDV, DomainVal_t &ODV) {
-    DomainVal_t useSet(DomainVector.size());
-    const Instruction *instr = &Inst;
-
-    std::vector<dfa::Variable> varUseSet;
-
-    for (auto Iter = instr->op_begin(); Iter != instr->op_end(); ++Iter) {
-        Value *V = *Iter;
-        if (isa<Instruction>(V) || isa<Argument>(V)) {
-            dfa::Variable var = dfa::Variable(V);
-            // A variable is live at some point if it holds a value that may be needed in the future,
-            // or equivalently if its value may be read before the next time the variable is written to.
-            // therefore we must treat all incomingValue of a PHI node as uses
-            auto it = std::find(DomainVector.begin(), DomainVector.end(), var);
-            if (it != DomainVector.end()) {
-                size_t index = std::distance(DomainVector.begin(), it);
-                useSet[index] = {.Value = true};
-                varUseSet.push_back(var);
-            }
-        }
-    }
-
-
-    DomainVal_t defSet = IDV;
-    for (size_t DomainId = 0; DomainId < DomainVector.size(); ++DomainId) {
-        if (!static_cast<bool>(IDV[DomainId])) {
-            continue;
-        }
-        // kill all Input domain value that contains current instruction
-        // since we kill all def values
-        if (DomainVector[DomainId].contain(instr)) {
-            defSet[DomainId] = {.Value = false};
-        }
-    }
-    // union the two section
-    for (size_t DomainId = 0; DomainId < ODV.size(); ++DomainId) {
-        ODV[DomainId] = useSet[DomainId] | defSet[DomainId];
-    }
-
-    DomainVal_t prevOutput = InstDomainValMap.at(instr);
-    // compare previous and current output
-    for (size_t DomainId = 0; DomainId < prevOutput.size(); ++DomainId) {
-        if (prevOutput[DomainId].Value != ODV[DomainId].Value) {
-            return true;
-        }
-    }
-    return false;
-}
-
+#include "DFA.h"
+#include <DFA/Flow/Summaries.h>
+#include <iostream>
+#include <llvm/ADT/DepthFirstIterator.h>
+#include <llvm/Analysis/CFG.h>
+#include <llvm/Analysis/IteratedDominanceFrontier.h>
+#include <llvm/Analysis/PostDominators.h>
+#include <llvm/IR/IRBuilder.h>
+#include <llvm/Transforms/Utils/BasicBlockUtils.h>
+
+using namespace llvm;
+
+AnalysisKey Liveness::Key;
+
+template class dfa::Framework<
+        Liveness, dfa::Variable, dfa::Bool, dfa::Union<dfa::Bool>,
+        dfa::BackwardMeetBBConstRange_t, dfa::BackwardDependentBBConstRange_t,
+        dfa::BackwardBBConstRange_t, dfa::BackwardInstConstRange_t>;
+template class dfa::BackwardAnalysis<Liveness, dfa::Variable, dfa::Bool, dfa::Union<dfa::Bool>>;
+template class dfa::Framework<
+        StrongLiveness, dfa::Variable, dfa::Bool, dfa::Union<dfa::Bool>,
+        dfa::BackwardMeetBBConstRange_t, dfa::BackwardDependentBBConstRange_t,
+        dfa::BackwardBBConstRange_t, dfa::BackwardInstConstRange_t>;
+template class dfa::BackwardAnalysis<StrongLiveness, dfa::Variable, dfa::Bool, dfa::Union<dfa::Bool>>;
+
+bool Liveness::isDeadArgUse(const Use &U) const {
+    const auto *const Call = dyn_cast<CallBase>(U.getUser());
+    return Summaries != nullptr && Call != nullptr && Call->isArgOperand(&U) &&
+           !Summaries->isArgLive(*Call, Call->getArgOperandNo(&U));
+}
+
+ArrayRef<unsigned> Liveness::getUseIds(const Instruction &Inst) {
+    const ArrayRef<unsigned> UseIds = InstUseIds.lookup(&Inst);
+    if (Summaries == nullptr || !isa<CallBase>(Inst)) {
+        return UseIds;
+    }
+    // the ids are recorded in operand order, for the operands that are
+    // variables
+    LiveUseIds.clear();
+    const unsigned *Id = UseIds.begin();
+    for (const Use &Op : Inst.operands()) {
+        if (!isa<Instruction>(Op) && !isa<Argument>(Op)) {
+            continue;
+        }
+        if (!isDeadArgUse(Op)) {
+            LiveUseIds.push_back(*Id);
+        }
+        ++Id;
+    }
+    return LiveUseIds;
+}
+
+bool Liveness::isLiveOnEntry(const Argument &Arg) {
+    const auto It = DomainIdMap.find(dfa::Variable(&Arg));
+    if (It == DomainIdMap.end()) {
+        return false;
+    }
+    return getValueAt(Arg.getParent()->getEntryBlock().front()).test(It->second);
+}
+
+bool Liveness::initGenKill(const Instruction &Inst, DomainVal_t &Gen, DomainVal_t &Kill) {
+    // A variable is live at some point if it holds a value that may be needed in the future,
+    // or equivalently if its value may be read before the next time the variable is written to.
+    // therefore we must treat all incomingValue of a PHI node as uses
+    for (const unsigned DomainId : getUseIds(Inst)) {
+        Gen.set(DomainId);
+    }
+    // kill all domain values that contain current instruction
+    // since we kill all def values
+    for (const unsigned DomainId : InstDefIds.lookup(&Inst)) {
+        Kill.set(DomainId);
+    }
+    return true;
+}
+
+bool Liveness::getGenKillIds(const Instruction &Inst, ArrayRef<unsigned> &GenIds,
+                             ArrayRef<unsigned> &KillIds) {
+    GenIds = getUseIds(Inst);
+    KillIds = InstDefIds.lookup(&Inst);
+    return true;
+}
+
+bool Liveness::solveSparse(const Function &F) {
+    // BVs hold the live-out sets, and BBOutVals the live-in ones
+    for (const BasicBlock &BB : F) {
+        BVs[&BB] = bc();
+        BBOutVals[&BB] = bc();
+    }
+    SmallVector<const BasicBlock *, 16> Worklist;
+    for (unsigned DomainId = 0; DomainId < DomainVector.size(); ++DomainId) {
+        const Value *const Var = DomainVector[DomainId].Var;
+        const auto *const DefInst = dyn_cast<Instruction>(Var);
+        // arguments are defined above the entry block
+        const BasicBlock *const DefBB =
+                DefInst != nullptr ? DefInst->getParent() : nullptr;
+        for (const Use &U : Var->uses()) {
+            const auto *const UseInst = dyn_cast<Instruction>(U.getUser());
+            if (UseInst == nullptr || isDeadArgUse(U)) {
+                continue;
+            }
+            // the variable is live-in at the block of the use, unless it is
+            // defined above the use (PHI incoming values count as uses at the
+            // PHI itself, which may come before the definition)
+            if (UseInst->getParent() == DefBB && DefInst->comesBefore(UseInst)) {
+                continue;
+            }
+            Worklist.push_back(UseInst->getParent());
+        }
+        while (!Worklist.empty()) {
+            const BasicBlock *const BB = Worklist.pop_back_val();
+            DomainVal_t &LiveIn = BBOutVals.at(BB);
+            if (LiveIn.test(DomainId)) {
+                continue;
+            }
+            ++NumBlockVisits;
+            LiveIn.set(DomainId);
+            for (const BasicBlock *const Pred : predecessors(BB)) {
+                DomainVal_t &LiveOut = BVs.at(Pred);
+                if (LiveOut.test(DomainId)) {
+                    continue;
+                }
+                LiveOut.set(DomainId);
+                // the definition ends the walk
+                if (Pred != DefBB) {
+                    Worklist.push_back(Pred);
+                }
+            }
+        }
+    }
+    return true;
+}
+
+/// @brief Check whether @p Inst is live whatever the variables, i.e., it has
+///        an effect, or it is a terminator other than a branch (e.g., a
+///        return).
+static bool isRoot(const Instruction &Inst) {
+    // (the branches are only live through the instructions that depend on
+    // them)
+    if (Inst.isTerminator()) {
+        return !isa<BranchInst>(Inst) && !isa<SwitchInst>(Inst);
+    }
+    return Inst.mayHaveSideEffects() || Inst.isEHPad();
+}
+
+bool StrongLiveness::isLive(const Instruction &Inst, const DomainVal_t &Out) const {
+    if (isRoot(Inst) || LiveTerms.count(&Inst)) {
+        return true;
+    }
+    return llvm::any_of(InstDefIds.lookup(&Inst),
+                        [&Out](const unsigned DomainId) { return Out.test(DomainId); });
+}
+
+bool StrongLiveness::transferFunc(const Instruction &Inst, const DomainVal_t &IDV,
+                                  DomainVal_t &ODV) {
+    // the operands of a dead instruction are not needed by it
+    const ArrayRef<unsigned> UseIds = isLive(Inst, IDV) ? InstUseIds.lookup(&Inst)
+                                                        : ArrayRef<unsigned>();
+    return dfa::applyGenKill(IDV, UseIds, InstDefIds.lookup(&Inst), ODV, ScratchVal);
+}
+
+StrongLiveness::Removed StrongLiveness::eliminateDeadCode(Function &F) {
+    Removed Count;
+    // the blocks that are never reached go first, so that nothing in them is
+    // live, and the post-dominators are those of the reachable blocks
+    df_iterator_default_set<BasicBlock *> ReachableBBs;
+    for (BasicBlock *const BB : depth_first_ext(&F, ReachableBBs)) {
+        (void)BB;
+    }
+    SmallVector<BasicBlock *, 8> DeadBBs;
+    for (BasicBlock &BB : F) {
+        if (!ReachableBBs.count(&BB)) {
+            DeadBBs.push_back(&BB);
+        }
+    }
+    DeleteDeadBlocks(DeadBBs);
+    Count.BBs = DeadBBs.size();
+
+    PostDominatorTree PDT(F);
+    LiveTerms.clear();
+    // unless the function has to make progress, a loop that may not terminate
+    // is an effect of its own, which its back edges keep
+    if (!F.mustProgress()) {
+        SmallVector<std::pair<const BasicBlock *, const BasicBlock *>, 8> BackEdges;
+        FindFunctionBackedges(F, BackEdges);
+        for (const auto &BackEdge : BackEdges) {
+            LiveTerms.insert(BackEdge.first->getTerminator());
+        }
+    }
+    // so is a branch without a post-dominator to jump to instead (e.g., in a
+    // loop that never exits)
+    for (const BasicBlock &BB : F) {
+        const DomTreeNode *const Node = PDT.getNode(&BB);
+        if (Node == nullptr || Node->getIDom() == nullptr ||
+            Node->getIDom()->getBlock() == nullptr) {
+            LiveTerms.insert(BB.getTerminator());
+        }
+    }
+
+    // the branches that decide whether a live block is reached are live, and
+    // so are the operands of their conditions, which may in turn make more
+    // blocks live
+    DenseSet<const Instruction *> LiveInsts;
+    ReverseIDFCalculator IDFs(PDT);
+    while (true) {
+        reset();
+        solve(F);
+        LiveInsts.clear();
+        // the blocks of the live instructions, and the incoming blocks of the
+        // live PHI nodes, as the branches to those decide on the value
+        SmallPtrSet<BasicBlock *, 16> LiveBBs;
+        for (BasicBlock &BB : F) {
+            const DomainVal_t *Out = &BVs.at(&BB);
+            for (const Instruction &Inst : llvm::reverse(BB)) {
+                if (isLive(Inst, *Out)) {
+                    LiveInsts.insert(&Inst);
+                    LiveBBs.insert(&BB);
+                    if (const auto *const PHI = dyn_cast<PHINode>(&Inst)) {
+                        LiveBBs.insert(PHI->block_begin(), PHI->block_end());
+                    }
+                }
+                Out = &InstDomainValMap.at(&Inst);
+            }
+        }
+        SmallVector<BasicBlock *, 16> ControlBBs;
+        IDFs.setDefiningBlocks(LiveBBs);
+        IDFs.calculate(ControlBBs);
+        bool Changed = false;
+        for (const BasicBlock *const BB : ControlBBs) {
+            Changed |= LiveTerms.insert(BB->getTerminator()).second;
+        }
+        if (!Changed) {
+            break;
+        }
+    }
+
+    // no live instruction is control dependent on a dead branch, hence none is
+    // between the branch and its post-dominator, which it can jump to directly
+    for (BasicBlock &BB : F) {
+        Instruction *const Term = BB.getTerminator();
+        const auto *const Branch = dyn_cast<BranchInst>(Term);
+        if (LiveInsts.count(Term) ||
+            !(isa<SwitchInst>(Term) || (Branch != nullptr && Branch->isConditional()))) {
+            continue;
+        }
+        BasicBlock *const PostDom = PDT.getNode(&BB)->getIDom()->getBlock();
+        // the PHI nodes of the post-dominator keep their value from the block
+        // if it is a successor already (if it is not, they are all dead, as
+        // their other incoming blocks would otherwise make the branch live)
+        SmallVector<std::pair<PHINode *, Value *>, 4> Incoming;
+        for (PHINode &PHI : PostDom->phis()) {
+            const int Idx = PHI.getBasicBlockIndex(&BB);
+            if (Idx != -1) {
+                Incoming.emplace_back(&PHI, PHI.getIncomingValue(Idx));
+            }
+        }
+        for (BasicBlock *const Succ : successors(&BB)) {
+            Succ->removePredecessor(&BB, /*KeepOneInputPHIs=*/true);
+        }
+        BranchInst::Create(PostDom, Term);
+        Term->eraseFromParent();
+        for (const auto &[PHI, Val] : Incoming) {
+            PHI->addIncoming(Val, &BB);
+        }
+        ++Count.Branches;
+    }
+    SmallVector<Instruction *, 32> DeadInsts;
+    for (Instruction &Inst : instructions(F)) {
+        if (!Inst.isTerminator() && !LiveInsts.count(&Inst)) {
+            DeadInsts.push_back(&Inst);
+        }
+    }
+    // (the dead instructions may use each other, e.g., around a loop)
+    for (Instruction *const Inst : DeadInsts) {
+        Inst->dropAllReferences();
+    }
+    for (Instruction *const Inst : DeadInsts) {
+        Inst->eraseFromParent();
+    }
+    Count.Insts = DeadInsts.size();
+
+    // the blocks between the dead branches and their post-dominators are no
+    // longer reached
+    ReachableBBs.clear();
+    for (BasicBlock *const BB : depth_first_ext(&F, ReachableBBs)) {
+        (void)BB;
+    }
+    DeadBBs.clear();
+    for (BasicBlock &BB : F) {
+        if (!ReachableBBs.count(&BB)) {
+            DeadBBs.push_back(&BB);
+        }
+    }
+    DeleteDeadBlocks(DeadBBs);
+    Count.BBs += DeadBBs.size();
+    return Count;
+}
+
+PreservedAnalyses LivenessADCEPass::run(Function &F, FunctionAnalysisManager &FAM) {
+    // the elimination solves the analysis itself, and prints nothing but its
+    // own report
+    dfa::Options ADCEOpts = Opts;
+    ADCEOpts.Transform = true;
+    const StrongLiveness::Removed Count = StrongLiveness(ADCEOpts).eliminateDeadCode(F);
+    if (Opts.Output != dfa::OutputMode::Quiet) {
+        LOG_ANALYSIS_INFO << "@" << F.getName() << ": " << Count.Insts
+                          << " instructions and " << Count.BBs << " blocks removed";
+    }
+    if (Count.Insts == 0 && Count.BBs == 0 && Count.Branches == 0) {
+        return PreservedAnalyses::all();
+    }
+    if (Count.BBs == 0 && Count.Branches == 0) {
+        PreservedAnalyses PA;
+        PA.preserveSet<CFGAnalyses>();
+        return PA;
+    }
+    return PreservedAnalyses::none();
+}
@@ -1,132 +1,514 @@
-#include "DFA.h"
-#include <iostream>
-#include <llvm/IR/IRBuilder.h>
-using namespace llvm;
-
-AnalysisKey SCCP::Key;
-
-bool SCCP::transferFunc(const Instruction &Inst, const DomainVal_t &IDV,
-                        DomainVal_t &ODV) {
-    const Instruction *instr = &Inst;
-    if (InstExecutable[instr]) {
-        ODV = IDV;
-        dfa::Lattice currentLattice = dfa::Lattice();
-        dfa::Variable var = dfa::Variable(instr);
-        auto it = std::find(DomainVector.begin(), DomainVector.end(), var);
-        if (it != DomainVector.end()) {
-            size_t index = std::distance(DomainVector.begin(), it);
-            currentLattice = ODV[index];
-        }
-        std::vector<dfa::Lattice> useLattice;
-        std::vector<ConstantInt *> cVector;
-        std::vector<dfa::Variable> vVector;
-        // check operands of instr are constant
-        for (auto Iter = instr->op_begin(); Iter != instr->op_end(); ++Iter) {
-            Value *V = *Iter;
-            if (ConstantInt *CI = dyn_cast<ConstantInt>(V)) {
-                dfa::Lattice use;
-                use.markConstant(CI);
-                useLattice.push_back(use);
-                cVector.push_back(CI);
-
-            } else if (isa<Instruction>(V) || isa<Argument>(V)) {
-                dfa::Variable var = dfa::Variable(V);
-                auto it = std::find(DomainVector.begin(), DomainVector.end(), var);
-                if (it != DomainVector.end()) {
-                    vVector.push_back(var);
-                    size_t index = std::distance(DomainVector.begin(), it);
-                    useLattice.push_back(IDV[index]);
-                }
-            }
-        }
-        bool allconstant = true;
-        for (dfa::Lattice l: useLattice) {
-            allconstant = allconstant && l.isConstant();
-        }
-
-        if (isa<PHINode>(instr)) {
-            const llvm::PHINode *phi  = dyn_cast<PHINode>(instr);
-            for (unsigned int i = 0; i < phi->getNumIncomingValues(); i++) {
-                Value *V = phi->getIncomingValue(i);
-                if (ConstantInt *CI = dyn_cast<ConstantInt>(V)) {
-                    dfa::Lattice use;
-                    use.markConstant(CI);
-                    currentLattice = currentLattice & use;
-                } else {
-                    BasicBlock* bb = phi->getIncomingBlock(i);
-                    dfa::Variable phiVar = dfa::Variable(V);
-                    auto it = std::find(DomainVector.begin(), DomainVector.end(), phiVar);
-                    if (it != DomainVector.end()) {
-                        size_t index = std::distance(DomainVector.begin(), it);
-                        currentLattice = currentLattice & InstDomainValMap[&bb->back()][index];
-                    }
-                }
-            }
-        }
-        else if (instr->getOpcode() == llvm::Instruction::Add && allconstant && useLattice.size() >= 2) {
-            // if instruction is add instruction and all use constant evaluate and set currentLattice
-            // also assumes all constant are int???
-            llvm::APInt resultValue = useLattice[0].Constant->getValue() + useLattice[1].Constant->getValue();
-            auto newCurrentLattice = dfa::Lattice();
-            llvm::LLVMContext& context =  Inst.getParent()->getContext();
-            newCurrentLattice.markConstant(llvm::ConstantInt::get(context, resultValue));
-            currentLattice = currentLattice & newCurrentLattice;
-        } else if (instr->getOpcode() == llvm::Instruction::Add) {
-            for (dfa::Lattice l: useLattice) {
-                currentLattice = currentLattice & l;
-            }
-        } else if (instr->getOpcode() == llvm::Instruction::ICmp && allconstant && useLattice.size() >= 2) {
-            // if instruction is a icmp instruction and use is constant evaluate to true and false
-            const llvm::ICmpInst *icmp = dyn_cast<ICmpInst>(instr);
-            auto constantExpr = llvm::ConstantExpr::getICmp(icmp->getPredicate(), useLattice[0].Constant, useLattice[1].Constant);
-            auto newCurrentLattice = dfa::Lattice();
-            llvm::LLVMContext& context =  Inst.getParent()->getContext();
-            // previous constant
-            newCurrentLattice.markConstant(llvm::ConstantInt::get(context, constantExpr->getUniqueInteger()));
-            currentLattice = currentLattice & newCurrentLattice;
-        } else if (instr->getOpcode() == llvm::Instruction::ICmp ) {
-            for (dfa::Lattice l: useLattice) {
-                currentLattice = currentLattice & l;
-            }
-        }
-
-        if (instr->getOpcode() == llvm::Instruction::Br && useLattice.size() >= 1) {
-            const llvm::BranchInst* branchInst = dyn_cast<BranchInst>(instr);
-            if (useLattice[0].isConstant()) {
-                bool branchTaken = useLattice[0].Constant->getUniqueInteger().getBoolValue();
-                if (branchTaken) {
-                    InstExecutable[&branchInst->getSuccessor(0)->front()] = true;
-                } else {
-                    InstExecutable[&branchInst->getSuccessor(1)->front()] = true;
-                }
-            } else {
-                // if branch instruction mark and evaluation of conditional is bottom the
-                //                                           mark both next block as executable
-                for (unsigned int i = 0; i < llvm::succ_size(Inst.getParent()); ++i) {
-                    InstExecutable[&branchInst->getSuccessor(i)->front()] = true;
-                }
-            }
-        } else if (instr->getOpcode() == llvm::Instruction::Br) {
-            // mark unconditional branch next
-            const llvm::BranchInst* branchInst = dyn_cast<BranchInst>(instr);
-            InstExecutable[&branchInst->getSuccessor(0)->front()] = true;
-        } else {
-            // mark next instruction as executable
-            const llvm::Instruction *nextInst = Inst.getNextNode();
-            if (nextInst != nullptr) {
-                InstExecutable[nextInst] = true;
-            }
-        }
-        if (it != DomainVector.end()) {
-            size_t index = std::distance(DomainVector.begin(), it);
-            if (ODV[index] == currentLattice) {
-                return false;
-            }
-            ODV[index] = ODV[index] & currentLattice;
-            return true;
-        }
-    } else {
-        ODV = InstDomainValMap[instr];
-    }
-    return false;
-}
\ No newline at end of file
+#include "DFA.h"
+#include <DFA/Flow/Summaries.h>
+#include <llvm/IR/CFG.h>
+#include <llvm/Transforms/Utils/BasicBlockUtils.h>
+using namespace llvm;
+
+AnalysisKey SCCP::Key;
+
+template class dfa::Framework<
+        SCCP, dfa::Variable, dfa::Lattice, dfa::Intersect<dfa::Lattice>,
+        dfa::ForwardMeetBBConstRange_t, dfa::ForwardDependentBBConstRange_t,
+        dfa::ForwardBBConstRange_t, dfa::ForwardInstConstRange_t>;
+template class dfa::ForwardAnalysis<SCCP, dfa::Variable, dfa::Lattice, dfa::Intersect<dfa::Lattice>>;
+
+/// @brief Evaluate @p Inst over the constant operands @p ops , directly on
+///        @c APInt so that no constant is created in the context.
+/// @return False if the result is not a known constant (e.g., division by
+///         zero, or an unsupported operation).
+static bool foldInst(const Instruction &Inst, ArrayRef<APInt> ops, APInt &result) {
+    switch (Inst.getOpcode()) {
+    case Instruction::Add: result = ops[0] + ops[1]; return true;
+    case Instruction::Sub: result = ops[0] - ops[1]; return true;
+    case Instruction::Mul: result = ops[0] * ops[1]; return true;
+    case Instruction::And: result = ops[0] & ops[1]; return true;
+    case Instruction::Or: result = ops[0] | ops[1]; return true;
+    case Instruction::Xor: result = ops[0] ^ ops[1]; return true;
+    case Instruction::UDiv:
+    case Instruction::URem:
+        if (ops[1].isZero()) {
+            return false;
+        }
+        result = Inst.getOpcode() == Instruction::UDiv ? ops[0].udiv(ops[1])
+                                                       : ops[0].urem(ops[1]);
+        return true;
+    case Instruction::SDiv:
+    case Instruction::SRem:
+        if (ops[1].isZero()) {
+            return false;
+        }
+        // INT_MIN / -1 overflows
+        if (ops[0].isMinSignedValue() && ops[1].isAllOnes()) {
+            return false;
+        }
+        result = Inst.getOpcode() == Instruction::SDiv ? ops[0].sdiv(ops[1])
+                                                       : ops[0].srem(ops[1]);
+        return true;
+    case Instruction::Shl:
+    case Instruction::LShr:
+    case Instruction::AShr:
+        // shifting by the bit width or more gives poison
+        if (ops[1].uge(ops[0].getBitWidth())) {
+            return false;
+        }
+        result = Inst.getOpcode() == Instruction::Shl    ? ops[0].shl(ops[1])
+                 : Inst.getOpcode() == Instruction::LShr ? ops[0].lshr(ops[1])
+                                                         : ops[0].ashr(ops[1]);
+        return true;
+    case Instruction::ICmp:
+        result = APInt(1, ICmpInst::compare(ops[0], ops[1],
+                                            cast<ICmpInst>(Inst).getPredicate()));
+        return true;
+    case Instruction::Trunc:
+        result = ops[0].trunc(Inst.getType()->getIntegerBitWidth());
+        return true;
+    case Instruction::ZExt:
+        result = ops[0].zext(Inst.getType()->getIntegerBitWidth());
+        return true;
+    case Instruction::SExt:
+        result = ops[0].sext(Inst.getType()->getIntegerBitWidth());
+        return true;
+    default:
+        return false;
+    }
+}
+
+dfa::Lattice SCCP::getLattice(const Value *V) const {
+    dfa::Lattice lattice;
+    if (const auto *CI = dyn_cast<ConstantInt>(V)) {
+        lattice.markConstant(CI->getValue());
+        return lattice;
+    }
+    auto it = DomainIdMap.find(dfa::Variable(V));
+    if (it != DomainIdMap.end()) {
+        return Cells[it->second];
+    }
+    // any other constant (e.g., undef or a global) is not tracked
+    lattice.markOverdef();
+    return lattice;
+}
+
+void SCCP::updateCell(const Instruction &Inst, const dfa::Lattice &Val) {
+    // the value of an instruction is only in the domain if it is used
+    const ArrayRef<unsigned> defIds = InstDefIds.lookup(&Inst);
+    if (defIds.empty()) {
+        return;
+    }
+    dfa::Lattice &cell = Cells[defIds.front()];
+    const dfa::Lattice lowered = cell & Val;
+    if (lowered == cell) {
+        return;
+    }
+    cell = lowered;
+    for (const User *U : Inst.users()) {
+        if (const auto *userInst = dyn_cast<Instruction>(U)) {
+            SSAWorklist.push_back(userInst);
+        }
+    }
+}
+
+void SCCP::markEdgeExecutable(const BasicBlock *From, const BasicBlock *To) {
+    if (!ExecutableEdges.count({From, To})) {
+        FlowWorklist.emplace_back(From, To);
+    }
+}
+
+void SCCP::forEachTakenSucc(const Instruction &Term, LatticeLookup_t getOperand,
+                            function_ref<void(const BasicBlock *)> take) const {
+    if (const auto *branchInst = dyn_cast<BranchInst>(&Term)) {
+        if (branchInst->isUnconditional()) {
+            take(branchInst->getSuccessor(0));
+            return;
+        }
+        const dfa::Lattice cond = getOperand(branchInst->getCondition());
+        if (cond.isConstant()) {
+            // successor 0 is taken on true
+            take(branchInst->getSuccessor(cond.Constant.isZero() ? 1 : 0));
+        } else if (cond.isOverdef()) {
+            take(branchInst->getSuccessor(0));
+            take(branchInst->getSuccessor(1));
+        }
+        return;
+    }
+
+    if (const auto *switchInst = dyn_cast<SwitchInst>(&Term)) {
+        const dfa::Lattice cond = getOperand(switchInst->getCondition());
+        if (cond.isConstant()) {
+            const BasicBlock *dest = switchInst->getDefaultDest();
+            for (const auto &switchCase : switchInst->cases()) {
+                if (switchCase.getCaseValue()->getValue() == cond.Constant) {
+                    dest = switchCase.getCaseSuccessor();
+                    break;
+                }
+            }
+            take(dest);
+        } else if (cond.isOverdef()) {
+            for (const BasicBlock *succ : successors(&Term)) {
+                take(succ);
+            }
+        }
+        return;
+    }
+
+    for (const BasicBlock *succ : successors(&Term)) {
+        take(succ);
+    }
+}
+
+dfa::Lattice SCCP::evalInst(const Instruction &Inst, LatticeLookup_t getOperand) const {
+    // fold the operation once all its operands are constant, and wait while
+    // any of them is still undefined
+    dfa::Lattice val;
+    if (isa<BinaryOperator>(Inst) || isa<ICmpInst>(Inst) || isa<CastInst>(Inst)) {
+        SmallVector<APInt, 2> operands;
+        for (const Value *op : Inst.operands()) {
+            const dfa::Lattice opVal = getOperand(op);
+            if (opVal.isOverdef()) {
+                val.markOverdef();
+                break;
+            }
+            if (opVal.isUndef()) {
+                break;
+            }
+            operands.push_back(opVal.Constant);
+        }
+        if (operands.size() == Inst.getNumOperands()) {
+            APInt folded;
+            if (foldInst(Inst, operands, folded)) {
+                val.markConstant(folded);
+            } else {
+                val.markOverdef();
+            }
+        }
+    } else if (const auto *select = dyn_cast<SelectInst>(&Inst)) {
+        const dfa::Lattice cond = getOperand(select->getCondition());
+        if (cond.isConstant()) {
+            val = getOperand(cond.Constant.isZero() ? select->getFalseValue()
+                                                     : select->getTrueValue());
+        } else if (cond.isOverdef()) {
+            val = getOperand(select->getTrueValue()) & getOperand(select->getFalseValue());
+        }
+    } else if (const auto *call = dyn_cast<CallBase>(&Inst)) {
+        val = getCallLattice(*call);
+    } else {
+        // e.g., loads
+        val.markOverdef();
+    }
+    return val;
+}
+
+void SCCP::visitInst(const Instruction &Inst) {
+    ++NumTransferCalls;
+    const BasicBlock *BB = Inst.getParent();
+    const auto getOperand = [this](const Value *V) { return getLattice(V); };
+
+    if (const auto *phi = dyn_cast<PHINode>(&Inst)) {
+        // only the incoming values along executable edges are met
+        dfa::Lattice val;
+        for (unsigned i = 0; i < phi->getNumIncomingValues(); ++i) {
+            if (ExecutableEdges.count({phi->getIncomingBlock(i), BB})) {
+                val = val & getLattice(phi->getIncomingValue(i));
+                ++NumMeets;
+            }
+        }
+        updateCell(Inst, val);
+        return;
+    }
+
+    if (Inst.isTerminator()) {
+        // (e.g., the result of an invoke)
+        if (const auto *call = dyn_cast<CallBase>(&Inst)) {
+            updateCell(Inst, getCallLattice(*call));
+        }
+        forEachTakenSucc(Inst, getOperand, [&](const BasicBlock *succ) {
+            markEdgeExecutable(BB, succ);
+        });
+        return;
+    }
+
+    updateCell(Inst, evalInst(Inst, getOperand));
+}
+
+dfa::Lattice SCCP::getCallLattice(const CallBase &Call) const {
+    if (Summaries != nullptr) {
+        return Summaries->getReturn(Call);
+    }
+    dfa::Lattice val;
+    val.markOverdef();
+    return val;
+}
+
+dfa::Lattice SCCP::getArgLattice(const Argument &Arg) const {
+    if (Summaries != nullptr) {
+        return Summaries->getArg(Arg);
+    }
+    dfa::Lattice val;
+    val.markOverdef();
+    return val;
+}
+
+dfa::Lattice SCCP::getReturnLattice(const Function &F) const {
+    dfa::Lattice val;
+    for (const BasicBlock &BB : F) {
+        const auto *ret = dyn_cast<ReturnInst>(BB.getTerminator());
+        if (ret != nullptr && ret->getReturnValue() != nullptr && isExecutable(BB)) {
+            val = val & getLattice(ret->getReturnValue());
+        }
+    }
+    return val;
+}
+
+bool SCCP::solveSparse(const Function &F) {
+    Cells.assign(DomainVector.size(), dfa::Lattice());
+    ExecutableEdges.clear();
+    ExecutableBBs.clear();
+    // (for the dense solve that cross-checks this one, if any)
+    DenseExecEdges.clear();
+    DenseExecBBs.clear();
+    for (const Argument &arg : F.args()) {
+        auto it = DomainIdMap.find(dfa::Variable(&arg));
+        if (it != DomainIdMap.end()) {
+            Cells[it->second] = getArgLattice(arg);
+        }
+    }
+    // the entry block is reached through a virtual edge
+    FlowWorklist.emplace_back(nullptr, &F.getEntryBlock());
+    while (!FlowWorklist.empty() || !SSAWorklist.empty()) {
+        while (!FlowWorklist.empty()) {
+            const CFGEdge_t edge = FlowWorklist.pop_back_val();
+            if (!ExecutableEdges.insert(edge).second) {
+                continue;
+            }
+            const BasicBlock *BB = edge.second;
+            if (ExecutableBBs.insert(BB).second) {
+                ++NumBlockVisits;
+                for (const Instruction &I : *BB) {
+                    visitInst(I);
+                }
+            } else {
+                // a new incoming edge only affects the PHI nodes
+                for (const PHINode &phi : BB->phis()) {
+                    visitInst(phi);
+                }
+            }
+        }
+        while (!SSAWorklist.empty()) {
+            const Instruction *I = SSAWorklist.pop_back_val();
+            if (ExecutableBBs.count(I->getParent())) {
+                visitInst(*I);
+            }
+        }
+    }
+    return true;
+}
+
+bool SCCP::deriveBlockVals(const BasicBlock &BB, DomainVal_t &BV,
+                           InstVals_t *InstVals) {
+    BV = bc();
+    // walk backward from BB through the executable blocks: the variables
+    // defined in those reach it (arguments have no defining block, and stay
+    // undefined as in the boundary value of the entry block)
+    SmallPtrSet<const BasicBlock *, 16> visited;
+    SmallVector<const BasicBlock *, 16> worklist(predecessors(&BB));
+    while (!worklist.empty()) {
+        const BasicBlock *pred = worklist.pop_back_val();
+        if (!visited.insert(pred).second || !ExecutableBBs.count(pred)) {
+            continue;
+        }
+        for (const Instruction &I : *pred) {
+            const ArrayRef<unsigned> defIds = InstDefIds.lookup(&I);
+            if (!defIds.empty()) {
+                BV[defIds.front()] = Cells[defIds.front()];
+            }
+        }
+        worklist.append(pred_begin(pred), pred_end(pred));
+    }
+    if (InstVals == nullptr) {
+        return true;
+    }
+    const bool executable = ExecutableBBs.count(&BB) != 0;
+    const DomainVal_t *IDV = &BV;
+    for (const Instruction &I : BB) {
+        DomainVal_t &ODV = (*InstVals)[&I];
+        ++NumTransferCalls;
+        if (!executable) {
+            ODV = bc();
+            continue;
+        }
+        ODV = *IDV;
+        const ArrayRef<unsigned> defIds = InstDefIds.lookup(&I);
+        if (!defIds.empty()) {
+            ODV[defIds.front()] = Cells[defIds.front()];
+        }
+        IDV = &ODV;
+    }
+    return true;
+}
+
+void SCCP::writeSparseSolution(const Function &F, dfa::ResultWriter &Writer) const {
+    dfa::writeDomainVal(Writer, Cells);
+    BitVector executable(F.size());
+    size_t idx = 0;
+    for (const BasicBlock &BB : F) {
+        executable[idx++] = isExecutable(BB);
+    }
+    dfa::writeDomainVal(Writer, executable);
+}
+
+bool SCCP::readSparseSolution(const Function &F, dfa::ResultReader &Reader,
+                              const size_t DomainSize) {
+    if (!dfa::readDomainVal(Reader, Cells, DomainSize)) {
+        return false;
+    }
+    const uint32_t *executable = Reader.readWords((F.size() + 31) / 32);
+    if (executable == nullptr) {
+        return false;
+    }
+    // (the executable edges are only needed to rewrite the function, which
+    // is never cached)
+    ExecutableEdges.clear();
+    ExecutableBBs.clear();
+    size_t idx = 0;
+    for (const BasicBlock &BB : F) {
+        if ((executable[idx / 32] >> (idx % 32)) & 1) {
+            ExecutableBBs.insert(&BB);
+        }
+        ++idx;
+    }
+    return true;
+}
+
+bool SCCP::transferFunc(const Instruction &Inst, const DomainVal_t &IDV,
+                        DomainVal_t &ODV) {
+    const BasicBlock *BB = Inst.getParent();
+    // instructions that are never executed keep every variable undefined
+    if (!BB->isEntryBlock() && !DenseExecBBs.count(BB)) {
+        return false;
+    }
+    const auto getOperand = [&](const Value *V) {
+        dfa::Lattice lattice;
+        if (const auto *CI = dyn_cast<ConstantInt>(V)) {
+            lattice.markConstant(CI->getValue());
+            return lattice;
+        }
+        // (the arguments are defined above the entry block)
+        if (const auto *arg = dyn_cast<Argument>(V)) {
+            return getArgLattice(*arg);
+        }
+        auto it = DomainIdMap.find(dfa::Variable(V));
+        if (it != DomainIdMap.end()) {
+            return IDV[it->second];
+        }
+        lattice.markOverdef();
+        return lattice;
+    };
+
+    bool changed = false;
+    dfa::Lattice val;
+    if (const auto *phi = dyn_cast<PHINode>(&Inst)) {
+        for (unsigned i = 0; i < phi->getNumIncomingValues(); ++i) {
+            if (DenseExecEdges.count({phi->getIncomingBlock(i), BB})) {
+                val = val & getOperand(phi->getIncomingValue(i));
+                ++NumMeets;
+            }
+        }
+    } else if (Inst.isTerminator()) {
+        if (const auto *call = dyn_cast<CallBase>(&Inst)) {
+            val = getCallLattice(*call);
+        }
+        // a new executable edge has its target (re)visited, as the output of
+        // the block is reported as changed
+        forEachTakenSucc(Inst, getOperand, [&](const BasicBlock *succ) {
+            if (DenseExecEdges.insert({BB, succ}).second) {
+                DenseExecBBs.insert(succ);
+                changed = true;
+            }
+        });
+    } else {
+        val = evalInst(Inst, getOperand);
+    }
+    ScratchVal = IDV;
+    const ArrayRef<unsigned> defIds = InstDefIds.lookup(&Inst);
+    if (!defIds.empty()) {
+        ScratchVal[defIds.front()] = val;
+    }
+    if (ScratchVal == ODV) {
+        return changed;
+    }
+    std::swap(ScratchVal, ODV);
+    return true;
+}
+
+bool SCCP::rewrite(Function &F) {
+    bool changed = false;
+    LLVMContext &context = F.getContext();
+    // (the arguments are only known from the summaries of the callers)
+    for (Argument &arg : F.args()) {
+        const dfa::Lattice val = getLattice(&arg);
+        if (val.isConstant()) {
+            arg.replaceAllUsesWith(val.toConstant(context));
+            changed = true;
+        }
+    }
+    // replace the constant values (the blocks that are never executed are
+    // deleted below anyway)
+    for (BasicBlock &BB : F) {
+        if (!ExecutableBBs.count(&BB)) {
+            continue;
+        }
+        for (Instruction &I : make_early_inc_range(BB)) {
+            const ArrayRef<unsigned> defIds = InstDefIds.lookup(&I);
+            if (defIds.empty() || !Cells[defIds.front()].isConstant()) {
+                continue;
+            }
+            I.replaceAllUsesWith(Cells[defIds.front()].toConstant(context));
+            // calls with a constant result are kept for their side effects
+            if (!I.mayHaveSideEffects()) {
+                I.eraseFromParent();
+            }
+            changed = true;
+        }
+    }
+    // turn the terminators with a single executable successor into
+    // unconditional branches
+    for (BasicBlock &BB : F) {
+        Instruction *term = BB.getTerminator();
+        if (!ExecutableBBs.count(&BB) || term->getNumSuccessors() < 2) {
+            continue;
+        }
+        BasicBlock *dest = nullptr;
+        bool singleDest = true;
+        for (BasicBlock *succ : successors(&BB)) {
+            if (!ExecutableEdges.count({&BB, succ})) {
+                continue;
+            }
+            singleDest = singleDest && (dest == nullptr || dest == succ);
+            dest = succ;
+        }
+        if (dest == nullptr || !singleDest) {
+            continue;
+        }
+        // keep exactly one incoming edge from BB into dest
+        bool keptDest = false;
+        for (BasicBlock *succ : successors(&BB)) {
+            if (succ == dest && !keptDest) {
+                keptDest = true;
+                continue;
+            }
+            succ->removePredecessor(&BB);
+        }
+        BranchInst::Create(dest, term);
+        term->eraseFromParent();
+        changed = true;
+    }
+    SmallVector<BasicBlock *, 8> deadBBs;
+    for (BasicBlock &BB : F) {
+        if (!ExecutableBBs.count(&BB)) {
+            deadBBs.push_back(&BB);
+        }
+    }
+    // this also drops their incoming values from the PHI nodes, and folds the
+    // PHI nodes left with a single one
+    DeleteDeadBlocks(deadBBs);
+    return changed || !deadBBs.empty();
+}
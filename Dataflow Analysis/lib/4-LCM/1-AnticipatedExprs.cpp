@@ -1,3 +1,30 @@
-#include "LCM.h"
-
-/// @todo(CSCD70) Please complete this file.
+#include "LCM.h"
+
+using namespace llvm;
+
+template class dfa::Framework<
+        AnticipatedExprs, dfa::Expression, dfa::Bool, dfa::Intersect<dfa::Bool>,
+        dfa::BackwardMeetBBConstRange_t, dfa::BackwardDependentBBConstRange_t,
+        dfa::BackwardBBConstRange_t, dfa::BackwardInstConstRange_t>;
+template class dfa::BackwardAnalysis<AnticipatedExprs, dfa::Expression, dfa::Bool,
+        dfa::Intersect<dfa::Bool>>;
+
+bool AnticipatedExprs::initGenKill(const Instruction &Inst, DomainVal_t &Gen,
+                                   DomainVal_t &Kill) {
+    // an expression is anticipated right before the instruction evaluating it
+    for (const unsigned DomainId : InstUseIds.lookup(&Inst)) {
+        Gen.set(DomainId);
+    }
+    // but not above the definition of either of its operands
+    for (const unsigned DomainId : InstDefIds.lookup(&Inst)) {
+        Kill.set(DomainId);
+    }
+    return true;
+}
+
+bool AnticipatedExprs::transferFunc(const Instruction &Inst,
+                                    const DomainVal_t &IDV, DomainVal_t &ODV) {
+    // 𝐼𝑁 = e_use ∪ (𝑂𝑈𝑇 − e_kill)
+    return dfa::applyGenKill(IDV, InstUseIds.lookup(&Inst),
+                             InstDefIds.lookup(&Inst), ODV, ScratchVal);
+}
@@ -1,3 +1,37 @@
-#include "LCM.h"
-
-/// @todo(CSCD70) Please complete this file.
+#include "LCM.h"
+
+using namespace llvm;
+
+template class dfa::Framework<
+        WBAvailExprs, dfa::Expression, dfa::Bool, dfa::Intersect<dfa::Bool>,
+        dfa::ForwardMeetBBConstRange_t, dfa::ForwardDependentBBConstRange_t,
+        dfa::ForwardBBConstRange_t, dfa::ForwardInstConstRange_t>;
+template class dfa::ForwardAnalysis<WBAvailExprs, dfa::Expression, dfa::Bool,
+        dfa::Intersect<dfa::Bool>>;
+
+bool WBAvailExprs::initGenKill(const Instruction &Inst, DomainVal_t &Gen,
+                               DomainVal_t &Kill) {
+    for (const unsigned DomainId : InstDefIds.lookup(&Inst)) {
+        Kill.set(DomainId);
+    }
+    // an expression anticipated before the instruction could be placed
+    // there, hence it will be available after it unless it is killed
+    Gen = Anticipated.at(&Inst);
+    Gen.reset(Kill);
+    return true;
+}
+
+bool WBAvailExprs::transferFunc(const Instruction &Inst, const DomainVal_t &IDV,
+                                DomainVal_t &ODV) {
+    // 𝑂𝑈𝑇 = (anticipated.𝐼𝑁 ∪ 𝐼𝑁) − e_kill
+    ScratchVal = IDV;
+    ScratchVal |= Anticipated.at(&Inst);
+    for (const unsigned DomainId : InstDefIds.lookup(&Inst)) {
+        ScratchVal.reset(DomainId);
+    }
+    if (ScratchVal == ODV) {
+        return false;
+    }
+    std::swap(ScratchVal, ODV);
+    return true;
+}
@@ -1,3 +1,58 @@
-#include "LCM.h"
-
-/// @todo(CSCD70) Please complete this file.
+#include "LCM.h"
+
+#include <llvm/IR/InstIterator.h>
+
+using namespace llvm;
+
+size_t ExprPlacement::getUseId(const Instruction &Inst) const {
+    if (!dfa::Expression::isExpression(Inst)) {
+        return DomainVector.size();
+    }
+    return DomainIdMap.at(dfa::Expression(Inst));
+}
+
+void ExprPlacement::place(const Instruction &Inst, const BitVector &Val) {
+    if (Val.any()) {
+        Placements[&Inst] = Val;
+    } else {
+        Placements.erase(&Inst);
+    }
+}
+
+void ExprPlacement::print(const Function &F) const {
+    if (Opts.Output != dfa::OutputMode::Dump) {
+        return;
+    }
+    for (const Instruction &Inst : instructions(&F)) {
+        if (&Inst == &Inst.getParent()->front()) {
+            errs() << "\n";
+        }
+        outs() << Inst << "\n";
+        std::string StringBuf;
+        raw_string_ostream Strout(StringBuf);
+        Strout << "{";
+        for (const unsigned DomainId : at(Inst).set_bits()) {
+            Strout << DomainVector.at(DomainId) << ", ";
+        }
+        Strout << "}";
+        LOG_ANALYSIS_INFO << "\t" << StringBuf;
+    }
+}
+
+void EarliestPlacement::run(const Function &F) {
+    const auto &AnticipatedIns = std::get<3>(Anticipated);
+    const auto &WBAvailBVs = std::get<2>(WBAvail);
+    const auto &WBAvailOuts = std::get<3>(WBAvail);
+    BitVector Earliest;
+    for (const BasicBlock &BB : F) {
+        const BitVector *WBAvailIn = &WBAvailBVs.at(&BB);
+        for (const Instruction &Inst : BB) {
+            // earliest = anticipated.𝐼𝑁 − will-be-available.𝐼𝑁
+            Earliest = AnticipatedIns.at(&Inst);
+            Earliest.reset(*WBAvailIn);
+            place(Inst, Earliest);
+            WBAvailIn = &WBAvailOuts.at(&Inst);
+        }
+    }
+    print(F);
+}
@@ -1,3 +1,36 @@
-#include "LCM.h"
-
-/// @todo(CSCD70) Please complete this file.
+#include "LCM.h"
+
+using namespace llvm;
+
+template class dfa::Framework<
+        PostponableExprs, dfa::Expression, dfa::Bool, dfa::Intersect<dfa::Bool>,
+        dfa::ForwardMeetBBConstRange_t, dfa::ForwardDependentBBConstRange_t,
+        dfa::ForwardBBConstRange_t, dfa::ForwardInstConstRange_t>;
+template class dfa::ForwardAnalysis<PostponableExprs, dfa::Expression, dfa::Bool,
+        dfa::Intersect<dfa::Bool>>;
+
+bool PostponableExprs::initGenKill(const Instruction &Inst, DomainVal_t &Gen,
+                                   DomainVal_t &Kill) {
+    // a use is as far as an expression can be postponed
+    for (const unsigned DomainId : InstUseIds.lookup(&Inst)) {
+        Kill.set(DomainId);
+    }
+    Gen = Earliest.at(Inst);
+    Gen.reset(Kill);
+    return true;
+}
+
+bool PostponableExprs::transferFunc(const Instruction &Inst,
+                                    const DomainVal_t &IDV, DomainVal_t &ODV) {
+    // 𝑂𝑈𝑇 = (earliest ∪ 𝐼𝑁) − e_use
+    ScratchVal = IDV;
+    ScratchVal |= Earliest.at(Inst);
+    for (const unsigned DomainId : InstUseIds.lookup(&Inst)) {
+        ScratchVal.reset(DomainId);
+    }
+    if (ScratchVal == ODV) {
+        return false;
+    }
+    std::swap(ScratchVal, ODV);
+    return true;
+}
@@ -1,3 +1,60 @@
-#include "LCM.h"
-
-/// @todo(CSCD70) Please complete this file.
+#include "LCM.h"
+
+#include <llvm/IR/CFG.h>
+
+using namespace llvm;
+
+void LatestPlacement::run(const Function &F) {
+    const auto &PostponableBVs = std::get<2>(Postponable);
+    const auto &PostponableOuts = std::get<3>(Postponable);
+    // earliest ∪ postponable.𝐼𝑁 , i.e., where an expression could be placed
+    // (only the non-empty sets)
+    InstExprSets_t Placeable;
+    BitVector Val;
+    for (const BasicBlock &BB : F) {
+        const BitVector *PostponableIn = &PostponableBVs.at(&BB);
+        for (const Instruction &Inst : BB) {
+            Val = Earliest.at(Inst);
+            Val |= *PostponableIn;
+            if (Val.any()) {
+                Placeable[&Inst] = Val;
+            }
+            PostponableIn = &PostponableOuts.at(&Inst);
+        }
+    }
+    BitVector SuccPlaceable;
+    for (const auto &InstPlaceable : Placeable) {
+        const Instruction &Inst = *InstPlaceable.first;
+        const BasicBlock &BB = *Inst.getParent();
+        // the expressions that can be postponed to all the successors, none
+        // at the exit
+        SuccPlaceable = InstPlaceable.second;
+        auto intersectWith = [&](const Instruction &Succ) {
+            auto SuccIt = Placeable.find(&Succ);
+            if (SuccIt == Placeable.end()) {
+                SuccPlaceable.reset();
+            } else {
+                SuccPlaceable &= SuccIt->second;
+            }
+        };
+        if (const Instruction *Next = Inst.getNextNode()) {
+            intersectWith(*Next);
+        } else if (succ_empty(&BB)) {
+            SuccPlaceable.reset();
+        } else {
+            for (const BasicBlock *Succ : successors(&BB)) {
+                intersectWith(Succ->front());
+            }
+        }
+        // latest = placeable ∩ (e_use ∪ ¬(∩ placeable of the successors)),
+        // where the successors only matter within placeable
+        Val = InstPlaceable.second;
+        Val.reset(SuccPlaceable);
+        const size_t UseId = getUseId(Inst);
+        if (UseId != DomainVector.size() && InstPlaceable.second.test(UseId)) {
+            Val.set(UseId);
+        }
+        place(Inst, Val);
+    }
+    print(F);
+}
@@ -1,3 +1,36 @@
-#include "LCM.h"
-
-/// @todo(CSCD70) Please complete this file.
+#include "LCM.h"
+
+using namespace llvm;
+
+template class dfa::Framework<
+        UsedExprs, dfa::Expression, dfa::Bool, dfa::Union<dfa::Bool>,
+        dfa::BackwardMeetBBConstRange_t, dfa::BackwardDependentBBConstRange_t,
+        dfa::BackwardBBConstRange_t, dfa::BackwardInstConstRange_t>;
+template class dfa::BackwardAnalysis<UsedExprs, dfa::Expression, dfa::Bool,
+        dfa::Union<dfa::Bool>>;
+
+bool UsedExprs::initGenKill(const Instruction &Inst, DomainVal_t &Gen,
+                            DomainVal_t &Kill) {
+    // the value placed at the latest is not needed above the placement
+    Kill = Latest.at(Inst);
+    for (const unsigned DomainId : InstUseIds.lookup(&Inst)) {
+        Gen.set(DomainId);
+    }
+    Gen.reset(Kill);
+    return true;
+}
+
+bool UsedExprs::transferFunc(const Instruction &Inst, const DomainVal_t &IDV,
+                             DomainVal_t &ODV) {
+    // 𝐼𝑁 = (e_use ∪ 𝑂𝑈𝑇) − latest
+    ScratchVal = IDV;
+    for (const unsigned DomainId : InstUseIds.lookup(&Inst)) {
+        ScratchVal.set(DomainId);
+    }
+    ScratchVal.reset(Latest.at(Inst));
+    if (ScratchVal == ODV) {
+        return false;
+    }
+    std::swap(ScratchVal, ODV);
+    return true;
+}
@@ -0,0 +1,229 @@
+#include "LCM.h"
+
+#include <DFA/Transform/Redundancy.h>
+
+#include <llvm/ADT/SmallPtrSet.h>
+#include <llvm/ADT/SmallVector.h>
+#include <llvm/IR/CFG.h>
+#include <llvm/IR/Dominators.h>
+#include <llvm/Transforms/Utils/BasicBlockUtils.h>
+#include <llvm/Transforms/Utils/Local.h>
+
+#include <optional>
+
+using namespace llvm;
+
+/// @brief Get the point at which an expression placed before @p Inst is
+///        inserted, i.e., after the PHI nodes if @p Inst is one of them.
+static Instruction *getInsertPt(Instruction *const Inst) {
+    if (isa<PHINode>(Inst)) {
+        return &*Inst->getParent()->getFirstInsertionPt();
+    }
+    return Inst;
+}
+
+/// @brief Check that the operands of @p Expr are defined at @p InsertPt ,
+///        which the placement guarantees on the paths from the entry that
+///        reach the exit.
+static bool isPlaceableAt(const Instruction &Expr, Instruction *const InsertPt,
+                          const DominatorTree &DT) {
+    for (const Value *Op : Expr.operands()) {
+        const auto *const OpInst = dyn_cast<Instruction>(Op);
+        if (OpInst != nullptr && !DT.dominates(OpInst, InsertPt)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/// @brief Collect the rewrites of @p F given the latest placement and the
+///        used expressions: an expression is computed into a new value before
+///        every instruction where it is placed at the latest and used after,
+///        and each of its evaluations is replaced with that value, unless the
+///        expression is placed at the latest there and not used after (the
+///        evaluation is then the only use).
+/// @return The rewrites of every expression, indexed by domain id.
+static std::vector<ExprRewrite> collectRewrites(Function &F,
+                                                const LatestPlacement &Latest,
+                                                const UsedExprs::Result &Used) {
+    const auto &DomainIdMap = std::get<0>(Used);
+    const auto &DomainVector = std::get<1>(Used);
+    const auto &UsedBVs = std::get<2>(Used);
+    const auto &UsedIns = std::get<3>(Used);
+
+    std::vector<ExprRewrite> Rewrites(DomainVector.size());
+    for (BasicBlock &BB : F) {
+        for (Instruction &Inst : BB) {
+            const Instruction *const Next = Inst.getNextNode();
+            const BitVector &UsedOut =
+                    Next != nullptr ? UsedIns.at(Next) : UsedBVs.at(&BB);
+            BitVector Placed = Latest.at(Inst);
+            Placed &= UsedOut;
+            for (const unsigned DomainId : Placed.set_bits()) {
+                Rewrites[DomainId].InsertPts.push_back(&Inst);
+            }
+            if (!dfa::Expression::isExpression(Inst)) {
+                continue;
+            }
+            const size_t DomainId = DomainIdMap.at(dfa::Expression(Inst));
+            if (!Latest.at(Inst).test(DomainId) || UsedOut.test(DomainId)) {
+                Rewrites[DomainId].Redundant.push_back(&Inst);
+            }
+        }
+    }
+    return Rewrites;
+}
+
+/// @brief Abort if the rewrites of @c LCMSolver , @p Fused , differ from
+///        those of the stages run one by one, @p Staged .
+static void crossCheck(const std::vector<ExprRewrite> &Staged,
+                       const std::vector<ExprRewrite> &Fused) {
+    CHECK(Staged.size() == Fused.size())
+        << "The fused solver has " << Fused.size()
+        << " expressions, but the stages have " << Staged.size();
+    for (size_t DomainId = 0; DomainId < Staged.size(); ++DomainId) {
+        CHECK(Staged[DomainId].InsertPts == Fused[DomainId].InsertPts &&
+              Staged[DomainId].Redundant == Fused[DomainId].Redundant)
+            << "The fused solver and the stages disagree on expression "
+            << DomainId;
+    }
+}
+
+/// @brief Rewrite @p F as given by @p Rewrites (see @c collectRewrites ).
+/// @return True if @p F has been modified.
+static bool rewrite(Function &F, std::vector<ExprRewrite> Rewrites) {
+    const DominatorTree DT(F);
+    // all the computations are inserted before any evaluation is erased, as
+    // evaluations may also be insertion points
+    for (ExprRewrite &Rewrite : Rewrites) {
+        if (Rewrite.Redundant.empty() || Rewrite.InsertPts.empty()) {
+            Rewrite.Redundant.clear();
+            continue;
+        }
+        const Instruction &Expr = *Rewrite.Redundant.front();
+        // moving a division or a load up could make it trap before the side
+        // effects that come first
+        if (Instruction::isIntDivRem(Expr.getOpcode()) || isa<LoadInst>(Expr)) {
+            Rewrite.InsertPts.clear();
+            Rewrite.Redundant.clear();
+            continue;
+        }
+        for (Instruction *&InsertPt : Rewrite.InsertPts) {
+            InsertPt = getInsertPt(InsertPt);
+        }
+        // the analyses are vacuous over the paths that never exit (e.g.,
+        // infinite loops), so the expression is left alone if it would be
+        // placed above its operands
+        if (!llvm::all_of(Rewrite.InsertPts, [&](Instruction *const InsertPt) {
+                return isPlaceableAt(Expr, InsertPt, DT);
+            })) {
+            Rewrite.InsertPts.clear();
+            Rewrite.Redundant.clear();
+            continue;
+        }
+        const SmallVector<Instruction *, 4> Evals = Rewrite.Redundant;
+        for (Instruction *const InsertPt : Rewrite.InsertPts) {
+            // an evaluation placed at the latest is the computation itself
+            Instruction *Temp = InsertPt;
+            if (llvm::is_contained(Evals, Temp)) {
+                llvm::erase_value(Rewrite.Redundant, Temp);
+            } else {
+                Temp = Expr.clone();
+                Temp->setName(Expr.getName() + ".pre");
+                Temp->insertBefore(InsertPt);
+            }
+            Rewrite.Temps.push_back(Temp);
+        }
+    }
+
+    bool Changed = false;
+    for (ExprRewrite &Rewrite : Rewrites) {
+        if (Rewrite.Redundant.empty()) {
+            continue;
+        }
+        dfa::replaceRedundant(Rewrite.Temps, Rewrite.Redundant,
+                              Rewrite.Redundant.front()->getName() + ".pre-phi");
+        Changed = true;
+    }
+    return Changed;
+}
+
+/// @brief Run the stages one by one over @p F , printing their values.
+/// @return The rewrites of every expression, indexed by domain id.
+static std::vector<ExprRewrite> runStages(Function &F, FunctionAnalysisManager &FAM,
+                                          const dfa::Options &Opts) {
+    // the stages read each other's per-instruction values, and the function
+    // is rewritten, hence neither lazy nor cached
+    dfa::Options StageOpts = Opts;
+    StageOpts.Lazy = StageOpts.Sparse = StageOpts.CrossCheck = false;
+    StageOpts.Transform = true;
+    // (each result is released once the stages that read it are done)
+    std::optional<EarliestPlacement> Earliest;
+    {
+        const AnticipatedExprs::Result Anticipated =
+                AnticipatedExprs(StageOpts).run(F, FAM);
+        const WBAvailExprs::Result WBAvail =
+                WBAvailExprs(Anticipated, StageOpts).run(F, FAM);
+        Earliest.emplace(Anticipated, WBAvail, StageOpts);
+        Earliest->run(F);
+    }
+    std::optional<LatestPlacement> Latest;
+    {
+        const PostponableExprs::Result Postponable =
+                PostponableExprs(*Earliest, StageOpts).run(F, FAM);
+        Latest.emplace(*Earliest, Postponable, StageOpts);
+        Latest->run(F);
+    }
+    Earliest.reset();
+    const UsedExprs::Result Used = UsedExprs(*Latest, StageOpts).run(F, FAM);
+    return collectRewrites(F, *Latest, Used);
+}
+
+PreservedAnalyses LCMWrapperPass::run(Function &F,
+                                      FunctionAnalysisManager &FAM) {
+    SmallPtrSet<const BasicBlock *, 16> OrigBBs;
+    for (const BasicBlock &BB : F) {
+        OrigBBs.insert(&BB);
+    }
+    // a critical edge has no point of its own where an expression could be
+    // placed
+    SplitAllCriticalEdges(F);
+
+    // the stages are only run one by one if their values are printed
+    std::vector<ExprRewrite> Rewrites;
+    if (Opts.Output != dfa::OutputMode::Quiet || Opts.CrossCheck) {
+        Rewrites = runStages(F, FAM, Opts);
+    }
+    if (Opts.Output == dfa::OutputMode::Quiet || Opts.CrossCheck) {
+        std::vector<ExprRewrite> Fused = LCMSolver(Opts).run(F);
+        if (Opts.CrossCheck) {
+            crossCheck(Rewrites, Fused);
+        } else {
+            Rewrites = std::move(Fused);
+        }
+    }
+
+    const bool Changed = rewrite(F, std::move(Rewrites));
+    // merge back the split blocks in which nothing has been placed
+    SmallVector<BasicBlock *, 8> SplitBBs;
+    for (BasicBlock &BB : F) {
+        if (!OrigBBs.count(&BB)) {
+            SplitBBs.push_back(&BB);
+        }
+    }
+    bool SplitLeft = false;
+    for (BasicBlock *const BB : SplitBBs) {
+        if (&BB->front() != BB->getTerminator() ||
+            !TryToSimplifyUncondBranchFromEmptyBlock(BB)) {
+            SplitLeft = true;
+        }
+    }
+    if (!Changed && !SplitLeft) {
+        return PreservedAnalyses::all();
+    }
+    PreservedAnalyses PA;
+    if (!SplitLeft) {
+        PA.preserveSet<CFGAnalyses>();
+    }
+    return PA;
+}
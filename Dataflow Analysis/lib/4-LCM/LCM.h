@@ -1,15 +1,351 @@
-#pragma once // NOLINT(llvm-header-guard)
-
-#include <llvm/IR/Function.h>
-#include <llvm/IR/PassManager.h>
-
-class LCMWrapperPass : public llvm::PassInfoMixin<LCMWrapperPass> {
-public:
-  llvm::PreservedAnalyses run(llvm::Function &F,
-                              llvm::FunctionAnalysisManager &FAM) {
-
-    /// @todo(CSCD70) Get the result from the main body.
-
-    return llvm::PreservedAnalyses::all();
-  }
-};
+#pragma once // NOLINT(llvm-header-guard)
+
+#include <DFA/Domain/Expression.h>
+#include <DFA/Flow/BackwardAnalysis.h>
+#include <DFA/Flow/ForwardAnalysis.h>
+#include <DFA/MeetOp.h>
+
+#include <llvm/ADT/BitVector.h>
+#include <llvm/ADT/SmallVector.h>
+#include <llvm/IR/Function.h>
+#include <llvm/IR/PassManager.h>
+
+#include <unordered_map>
+#include <vector>
+
+/// Lazy Code Motion (Knoop, Rüthing and Steffen), following the formulation
+/// of the Dragon Book (§9.5) at the granularity of instructions: four
+/// analyses over the expressions (binary operators, comparisons, casts, GEPs
+/// and loads), interleaved with two placements that are computed directly
+/// from their results, then the rewriting (see @c LCMWrapperPass ). The stages
+/// are numbered as their files. The loads and the integer divisions are
+/// analyzed like the others but never moved, as they may trap.
+
+/// @brief Expression sets of every instruction.
+using InstExprSets_t =
+        std::unordered_map<const llvm::Instruction *, llvm::BitVector>;
+
+/// @brief (1) Anticipated expressions: an expression is anticipated at a
+///        point if every path from it evaluates the expression before either
+///        of its operands is redefined.
+class AnticipatedExprs final
+        : public dfa::BackwardAnalysis<AnticipatedExprs, dfa::Expression, dfa::Bool,
+                dfa::Intersect<dfa::Bool>> {
+private:
+    using BackwardAnalysis_t = dfa::BackwardAnalysis<AnticipatedExprs, dfa::Expression,
+            dfa::Bool, dfa::Intersect<dfa::Bool>>;
+    friend BackwardAnalysis_t::Framework_t;
+
+    std::string getName() const final { return "anticipated-expr"; }
+
+    DomainVal_t initVal() const { return DomainVal_t(DomainIdMap.size(), true); }
+    bool transferFunc(const llvm::Instruction &, const DomainVal_t &,
+                      DomainVal_t &);
+    bool initGenKill(const llvm::Instruction &, DomainVal_t &,
+                     DomainVal_t &);
+
+public:
+    using Result = typename BackwardAnalysis_t::AnalysisResult_t;
+    using BackwardAnalysis_t::run;
+
+    explicit AnticipatedExprs(const dfa::Options &Opts) : BackwardAnalysis_t(Opts) {}
+};
+
+/// @brief (2) Will-be-available expressions: an expression will be available
+///        at a point if, on every path to it, the expression is anticipated
+///        at some point (where it could be placed) and its operands are not
+///        redefined after.
+class WBAvailExprs final
+        : public dfa::ForwardAnalysis<WBAvailExprs, dfa::Expression, dfa::Bool,
+                dfa::Intersect<dfa::Bool>> {
+private:
+    using ForwardAnalysis_t = dfa::ForwardAnalysis<WBAvailExprs, dfa::Expression,
+            dfa::Bool, dfa::Intersect<dfa::Bool>>;
+    friend ForwardAnalysis_t::Framework_t;
+
+    /// Expressions anticipated before every instruction.
+    const std::unordered_map<const llvm::Instruction *, DomainVal_t> &Anticipated;
+
+    std::string getName() const final { return "will-be-avail-expr"; }
+
+    DomainVal_t initVal() const { return DomainVal_t(DomainIdMap.size(), true); }
+    bool transferFunc(const llvm::Instruction &, const DomainVal_t &,
+                      DomainVal_t &);
+    bool initGenKill(const llvm::Instruction &, DomainVal_t &,
+                     DomainVal_t &);
+
+public:
+    using Result = typename ForwardAnalysis_t::AnalysisResult_t;
+    using ForwardAnalysis_t::run;
+
+    WBAvailExprs(const AnticipatedExprs::Result &Anticipated,
+                 const dfa::Options &Opts)
+            : ForwardAnalysis_t(Opts), Anticipated(std::get<3>(Anticipated)) {}
+};
+
+/// @brief Expression sets computed from the results of the analyses rather
+///        than solved, and printed in the same way. The results are only read
+///        by @c run , and may be released after.
+class ExprPlacement {
+protected:
+    const dfa::Options Opts;
+    /// The domain, which is the same for all the stages.
+    const dfa::Expression::DomainIdMap_t DomainIdMap;
+    const dfa::Expression::DomainVector_t DomainVector;
+    /// Only the non-empty sets are stored, as most of them are empty.
+    InstExprSets_t Placements;
+    const llvm::BitVector Empty;
+
+    ExprPlacement(const dfa::Options &Opts,
+                  const dfa::Expression::DomainIdMap_t &DomainIdMap,
+                  const dfa::Expression::DomainVector_t &DomainVector)
+            : Opts(Opts), DomainIdMap(DomainIdMap), DomainVector(DomainVector),
+              Empty(DomainVector.size()) {}
+
+    virtual std::string getName() const = 0;
+    llvm::raw_ostream &errs() const { return llvm::errs(); }
+
+    /// @brief Get the id of the expression evaluated by @p Inst , or
+    ///        @c DomainVector.size() if there is none.
+    size_t getUseId(const llvm::Instruction &Inst) const;
+    /// @brief Set the placement of @p Inst to @p Val .
+    void place(const llvm::Instruction &Inst, const llvm::BitVector &Val);
+    /// @brief Print the placements after every instruction, unless quiet.
+    void print(const llvm::Function &F) const;
+
+public:
+    virtual ~ExprPlacement() {}
+
+    const llvm::BitVector &at(const llvm::Instruction &Inst) const {
+        auto PlacementIt = Placements.find(&Inst);
+        return PlacementIt != Placements.end() ? PlacementIt->second : Empty;
+    }
+};
+
+/// @brief (3) Earliest placement: an expression is placed before an
+///        instruction at the earliest if it is anticipated there but not
+///        (will be) available yet, i.e., it cannot be placed any higher.
+class EarliestPlacement final : public ExprPlacement {
+private:
+    const AnticipatedExprs::Result &Anticipated;
+    const WBAvailExprs::Result &WBAvail;
+
+    std::string getName() const final { return "earliest"; }
+
+public:
+    EarliestPlacement(const AnticipatedExprs::Result &Anticipated,
+                      const WBAvailExprs::Result &WBAvail,
+                      const dfa::Options &Opts)
+            : ExprPlacement(Opts, std::get<0>(Anticipated), std::get<1>(Anticipated)),
+              Anticipated(Anticipated), WBAvail(WBAvail) {}
+
+    void run(const llvm::Function &F);
+};
+
+/// @brief (4) Postponable expressions: an expression is postponable to a
+///        point if, on every path to it, the expression has been placed at
+///        the earliest and not used since.
+class PostponableExprs final
+        : public dfa::ForwardAnalysis<PostponableExprs, dfa::Expression, dfa::Bool,
+                dfa::Intersect<dfa::Bool>> {
+private:
+    using ForwardAnalysis_t = dfa::ForwardAnalysis<PostponableExprs, dfa::Expression,
+            dfa::Bool, dfa::Intersect<dfa::Bool>>;
+    friend ForwardAnalysis_t::Framework_t;
+
+    const EarliestPlacement &Earliest;
+
+    std::string getName() const final { return "postponable-expr"; }
+
+    DomainVal_t initVal() const { return DomainVal_t(DomainIdMap.size(), true); }
+    bool transferFunc(const llvm::Instruction &, const DomainVal_t &,
+                      DomainVal_t &);
+    bool initGenKill(const llvm::Instruction &, DomainVal_t &,
+                     DomainVal_t &);
+
+public:
+    using Result = typename ForwardAnalysis_t::AnalysisResult_t;
+    using ForwardAnalysis_t::run;
+
+    PostponableExprs(const EarliestPlacement &Earliest, const dfa::Options &Opts)
+            : ForwardAnalysis_t(Opts), Earliest(Earliest) {}
+};
+
+/// @brief (5) Latest placement: an expression is placed before an
+///        instruction at the latest if it could be placed there (earliest or
+///        postponable), and either the instruction uses it or it cannot be
+///        postponed to all the successors.
+class LatestPlacement final : public ExprPlacement {
+private:
+    const EarliestPlacement &Earliest;
+    const PostponableExprs::Result &Postponable;
+
+    std::string getName() const final { return "latest"; }
+
+public:
+    LatestPlacement(const EarliestPlacement &Earliest,
+                    const PostponableExprs::Result &Postponable,
+                    const dfa::Options &Opts)
+            : ExprPlacement(Opts, std::get<0>(Postponable), std::get<1>(Postponable)),
+              Earliest(Earliest), Postponable(Postponable) {}
+
+    void run(const llvm::Function &F);
+};
+
+/// @brief (6) Used expressions: an expression is used after a point if some
+///        path from it uses the expression before it is placed again at the
+///        latest, i.e., the value placed before the point is needed.
+class UsedExprs final
+        : public dfa::BackwardAnalysis<UsedExprs, dfa::Expression, dfa::Bool,
+                dfa::Union<dfa::Bool>> {
+private:
+    using BackwardAnalysis_t = dfa::BackwardAnalysis<UsedExprs, dfa::Expression,
+            dfa::Bool, dfa::Union<dfa::Bool>>;
+    friend BackwardAnalysis_t::Framework_t;
+
+    const LatestPlacement &Latest;
+
+    std::string getName() const final { return "used-expr"; }
+
+    bool transferFunc(const llvm::Instruction &, const DomainVal_t &,
+                      DomainVal_t &);
+    bool initGenKill(const llvm::Instruction &, DomainVal_t &,
+                     DomainVal_t &);
+
+public:
+    using Result = typename BackwardAnalysis_t::AnalysisResult_t;
+    using BackwardAnalysis_t::run;
+
+    UsedExprs(const LatestPlacement &Latest, const dfa::Options &Opts)
+            : BackwardAnalysis_t(Opts), Latest(Latest) {}
+};
+
+/// @brief The placements of an expression, and its evaluations that are
+///        replaced.
+struct ExprRewrite {
+    /// Instructions before which the expression is computed.
+    llvm::SmallVector<llvm::Instruction *, 4> InsertPts;
+    llvm::SmallVector<llvm::Instruction *, 4> Redundant;
+    /// The new computations, in the order of @c InsertPts .
+    llvm::SmallVector<llvm::Instruction *, 4> Temps;
+};
+
+/// @brief All the stages at once, over one domain, one block order and one
+///        set of per-block rows: the four analyses are solved at block
+///        granularity, and each sweep over the instructions in between
+///        computes the block summaries of the next analysis from the
+///        converged values of the previous ones. Within a block, a value
+///        only changes at the expressions an instruction uses or kills, hence
+///        the sweeps only touch those bits, and the whole rows are only
+///        combined once per block. The rewrites are the same as those of the
+///        stages one by one (see @c LCMWrapperPass ).
+class LCMSolver {
+private:
+    using Rows_t = std::vector<llvm::BitVector>;
+
+    const dfa::Options Opts;
+    dfa::Expression::DomainIdMap_t DomainIdMap;
+    dfa::Expression::DomainVector_t DomainVector;
+    dfa::InstDomainIdTable InstUseIds, InstDefIds;
+    /// Blocks in reverse post-order, followed by the unreachable ones, which
+    /// is the order of the rows.
+    std::vector<llvm::BasicBlock *> Order;
+    std::unordered_map<const llvm::BasicBlock *, size_t> BBIdxs;
+    std::vector<llvm::SmallVector<size_t, 2>> Preds, Succs;
+    /// GEN and KILL of every block, in the analysis being solved.
+    Rows_t Gen, Kill;
+    /// Boundary values of every block, i.e., the meet over its neighbors and
+    /// its output, in the direction of the analysis being solved.
+    Rows_t In, Out;
+    /// Whether the expressions that each instruction uses or kills are
+    /// anticipated after it, in the order of the instructions, starting at
+    /// @c AntOutBitsBegin of each block.
+    llvm::BitVector AntOutBits;
+    std::vector<size_t> AntOutBitsBegin;
+    /// Placements that are not empty, as ids.
+    dfa::InstDomainIdTable Earliest, Latest;
+    dfa::SolverStats Stats;
+
+    std::string getName() const { return "lcm"; }
+    llvm::raw_ostream &errs() const { return llvm::errs(); }
+
+    void initDomain(llvm::Function &F);
+    void initOrder(llvm::Function &F);
+    /// @brief Solve 𝑂𝑈𝑇 = GEN ∪ (𝐼𝑁 − KILL) into @c In and @c Out , where
+    ///        𝐼𝑁 is the meet over the predecessors (forward) or the successors
+    ///        (backward), and the empty set if there is none. The outputs
+    ///        start from the full set for the intersection.
+    void solve(bool Forward, bool Intersect);
+
+    /// @name Sweeps over the blocks, between the analyses
+    /// @{
+    /// @brief (1) GEN and KILL of the anticipated expressions.
+    void initAnticipated();
+    /// @brief (2) GEN of the will-be-available expressions, given the
+    ///        anticipated expressions at the end of every block.
+    void initWBAvail(const Rows_t &AntOut);
+    /// @brief (3) Earliest placement, then GEN and KILL of the postponable
+    ///        expressions (4).
+    void initPostponable(const Rows_t &AntIn, const Rows_t &WBAvailIn);
+    /// @brief (5) Latest placement, then GEN and KILL of the used
+    ///        expressions (6).
+    void initUsed(const Rows_t &PostponableIn);
+    /// @brief Collect the rewrites from the latest placement and the used
+    ///        expressions at the end of every block.
+    std::vector<ExprRewrite> collectRewrites(llvm::Function &F,
+                                             const Rows_t &UsedOut) const;
+    /// @}
+
+public:
+    explicit LCMSolver(const dfa::Options &Opts) : Opts(Opts) {}
+
+    /// @brief Solve all the stages over @p F .
+    /// @return The rewrites of every expression, indexed by domain id.
+    std::vector<ExprRewrite> run(llvm::Function &F);
+};
+
+/// @brief Partial redundancy elimination by Lazy Code Motion, e.g.,
+///        @c lcm<quiet> . The critical edges are split first, so that there
+///        is a point to place an expression on every edge. Each expression is
+///        then computed into a new value wherever it is placed at the latest
+///        and used after, and its evaluations that are redundant are replaced
+///        with that value. The split blocks that are left empty are merged
+///        back.
+class LCMWrapperPass : public llvm::PassInfoMixin<LCMWrapperPass> {
+private:
+    dfa::Options Opts;
+
+public:
+    explicit LCMWrapperPass(const dfa::Options &Opts = dfa::Options())
+            : Opts(Opts) {}
+
+    llvm::PreservedAnalyses run(llvm::Function &F,
+                                llvm::FunctionAnalysisManager &FAM);
+};
+
+// the solvers are instantiated next to the transfer functions (see the
+// numbered files of the stages)
+extern template class dfa::Framework<
+        AnticipatedExprs, dfa::Expression, dfa::Bool, dfa::Intersect<dfa::Bool>,
+        dfa::BackwardMeetBBConstRange_t, dfa::BackwardDependentBBConstRange_t,
+        dfa::BackwardBBConstRange_t, dfa::BackwardInstConstRange_t>;
+extern template class dfa::BackwardAnalysis<AnticipatedExprs, dfa::Expression,
+        dfa::Bool, dfa::Intersect<dfa::Bool>>;
+extern template class dfa::Framework<
+        WBAvailExprs, dfa::Expression, dfa::Bool, dfa::Intersect<dfa::Bool>,
+        dfa::ForwardMeetBBConstRange_t, dfa::ForwardDependentBBConstRange_t,
+        dfa::ForwardBBConstRange_t, dfa::ForwardInstConstRange_t>;
+extern template class dfa::ForwardAnalysis<WBAvailExprs, dfa::Expression,
+        dfa::Bool, dfa::Intersect<dfa::Bool>>;
+extern template class dfa::Framework<
+        PostponableExprs, dfa::Expression, dfa::Bool, dfa::Intersect<dfa::Bool>,
+        dfa::ForwardMeetBBConstRange_t, dfa::ForwardDependentBBConstRange_t,
+        dfa::ForwardBBConstRange_t, dfa::ForwardInstConstRange_t>;
+extern template class dfa::ForwardAnalysis<PostponableExprs, dfa::Expression,
+        dfa::Bool, dfa::Intersect<dfa::Bool>>;
+extern template class dfa::Framework<
+        UsedExprs, dfa::Expression, dfa::Bool, dfa::Union<dfa::Bool>,
+        dfa::BackwardMeetBBConstRange_t, dfa::BackwardDependentBBConstRange_t,
+        dfa::BackwardBBConstRange_t, dfa::BackwardInstConstRange_t>;
+extern template class dfa::BackwardAnalysis<UsedExprs, dfa::Expression,
+        dfa::Bool, dfa::Union<dfa::Bool>>;
@@ -0,0 +1,392 @@
+#include "LCM.h"
+
+#include <llvm/ADT/PostOrderIterator.h>
+#include <llvm/IR/CFG.h>
+#include <llvm/IR/InstIterator.h>
+#include <llvm/Support/Timer.h>
+
+using namespace llvm;
+
+void LCMSolver::initDomain(Function &F) {
+    dfa::Expression::Initializer Initializer(DomainIdMap, DomainVector,
+                                             InstUseIds);
+    Initializer.visit(F);
+    // an instruction kills the expressions that its users evaluate over it,
+    // and the loads that it may clobber (as in the framework)
+    SmallVector<unsigned, 8> MemoryIds;
+    for (unsigned Id = 0; Id < DomainVector.size(); ++Id) {
+        if (DomainVector[Id].readsMemory()) {
+            MemoryIds.push_back(Id);
+        }
+    }
+    SmallVector<unsigned, 8> Ids;
+    for (const Instruction &Inst : instructions(F)) {
+        Ids.clear();
+        for (const User *const U : Inst.users()) {
+            const auto *const UserInst = dyn_cast<Instruction>(U);
+            if (UserInst == nullptr) {
+                continue;
+            }
+            for (const unsigned Id : InstUseIds.lookup(UserInst)) {
+                if (DomainVector[Id].contain(&Inst)) {
+                    Ids.push_back(Id);
+                }
+            }
+        }
+        if (Inst.mayWriteToMemory()) {
+            for (const unsigned Id : MemoryIds) {
+                if (DomainVector[Id].mayBeClobberedBy(Inst)) {
+                    Ids.push_back(Id);
+                }
+            }
+        }
+        llvm::sort(Ids);
+        Ids.erase(std::unique(Ids.begin(), Ids.end()), Ids.end());
+        if (!Ids.empty()) {
+            InstDefIds.insert(&Inst, Ids);
+        }
+    }
+}
+
+void LCMSolver::initOrder(Function &F) {
+    for (BasicBlock *const BB : ReversePostOrderTraversal<Function *>(&F)) {
+        BBIdxs.emplace(BB, Order.size());
+        Order.push_back(BB);
+    }
+    for (BasicBlock &BB : F) {
+        if (BBIdxs.emplace(&BB, Order.size()).second) {
+            Order.push_back(&BB);
+        }
+    }
+    Preds.resize(Order.size());
+    Succs.resize(Order.size());
+    for (size_t Idx = 0; Idx < Order.size(); ++Idx) {
+        for (const BasicBlock *const Pred : predecessors(Order[Idx])) {
+            Preds[Idx].push_back(BBIdxs.at(Pred));
+        }
+        for (const BasicBlock *const Succ : successors(Order[Idx])) {
+            Succs[Idx].push_back(BBIdxs.at(Succ));
+        }
+    }
+}
+
+void LCMSolver::solve(const bool Forward, const bool Intersect) {
+    const size_t NumBBs = Order.size();
+    const auto &MeetIdxs = Forward ? Preds : Succs;
+    In.assign(NumBBs, BitVector(DomainVector.size()));
+    Out.assign(NumBBs, BitVector(DomainVector.size(), Intersect));
+    BitVector Scratch;
+    // round-robin in reverse post-order (forward) or post-order (backward),
+    // i.e., every block comes after its neighbors but for the back edges
+    for (bool Changed = true; Changed; ++Stats.Rounds) {
+        Changed = false;
+        for (size_t Step = 0; Step < NumBBs; ++Step) {
+            const size_t Idx = Forward ? Step : NumBBs - 1 - Step;
+            BitVector &BV = In[Idx];
+            if (MeetIdxs[Idx].empty()) {
+                BV.reset();
+            } else {
+                BV = Out[MeetIdxs[Idx].front()];
+                for (const size_t MeetIdx : llvm::drop_begin(MeetIdxs[Idx])) {
+                    if (Intersect) {
+                        BV &= Out[MeetIdx];
+                    } else {
+                        BV |= Out[MeetIdx];
+                    }
+                    ++Stats.Meets;
+                }
+            }
+            ++Stats.BlockVisits;
+            ++Stats.TransferCalls;
+            Changed |= dfa::applyGenKill(BV, Gen[Idx], Kill[Idx], Out[Idx],
+                                         Scratch);
+        }
+    }
+    size_t BytesHeld = AntOutBits.getMemorySize();
+    for (size_t Idx = 0; Idx < NumBBs; ++Idx) {
+        BytesHeld += In[Idx].getMemorySize() + Out[Idx].getMemorySize();
+    }
+    Stats.BytesHeld = std::max(Stats.BytesHeld, BytesHeld);
+}
+
+void LCMSolver::initAnticipated() {
+    const size_t NumBBs = Order.size();
+    Gen.assign(NumBBs, BitVector(DomainVector.size()));
+    Kill.assign(NumBBs, BitVector(DomainVector.size()));
+    AntOutBitsBegin.assign(NumBBs + 1, 0);
+    for (size_t Idx = 0; Idx < NumBBs; ++Idx) {
+        size_t NumBits = 0;
+        // 𝐼𝑁 = e_use ∪ (𝑂𝑈𝑇 − e_kill), composed from the end of the block
+        for (const Instruction &Inst : llvm::reverse(*Order[Idx])) {
+            const ArrayRef<unsigned> UseIds = InstUseIds.lookup(&Inst),
+                                     DefIds = InstDefIds.lookup(&Inst);
+            for (const unsigned Id : DefIds) {
+                Gen[Idx].reset(Id);
+                Kill[Idx].set(Id);
+            }
+            for (const unsigned Id : UseIds) {
+                Gen[Idx].set(Id);
+            }
+            NumBits += UseIds.size() + DefIds.size();
+        }
+        AntOutBitsBegin[Idx + 1] = AntOutBitsBegin[Idx] + NumBits;
+    }
+    AntOutBits.resize(AntOutBitsBegin.back());
+}
+
+void LCMSolver::initWBAvail(const Rows_t &AntOut) {
+    BitVector Ant, KilledAfter(DomainVector.size());
+    for (size_t Idx = 0; Idx < Order.size(); ++Idx) {
+        // 𝑂𝑈𝑇 = (anticipated.𝐼𝑁 ∪ 𝐼𝑁) − e_kill , composed over the block: an
+        // expression anticipated at some point will be available at the end
+        // unless it is killed after, and it is anticipated either at the end
+        // or right before an evaluation (the KILL is that of (1))
+        Ant = AntOut[Idx];
+        KilledAfter.reset();
+        BitVector &BBGen = Gen[Idx];
+        BBGen = AntOut[Idx];
+        size_t Pos = AntOutBitsBegin[Idx + 1];
+        bool IsLast = true;
+        for (const Instruction &Inst : llvm::reverse(*Order[Idx])) {
+            const ArrayRef<unsigned> UseIds = InstUseIds.lookup(&Inst),
+                                     DefIds = InstDefIds.lookup(&Inst);
+            Pos -= UseIds.size() + DefIds.size();
+            size_t BitPos = Pos;
+            for (const unsigned Id : UseIds) {
+                AntOutBits[BitPos++] = Ant.test(Id);
+            }
+            for (const unsigned Id : DefIds) {
+                AntOutBits[BitPos++] = Ant.test(Id);
+            }
+            for (const unsigned Id : DefIds) {
+                Ant.reset(Id);
+                KilledAfter.set(Id);
+                if (IsLast) {
+                    BBGen.reset(Id);
+                }
+            }
+            for (const unsigned Id : UseIds) {
+                Ant.set(Id);
+                if (!KilledAfter.test(Id)) {
+                    BBGen.set(Id);
+                }
+            }
+            IsLast = false;
+        }
+    }
+}
+
+void LCMSolver::initPostponable(const Rows_t &AntIn, const Rows_t &WBAvailIn) {
+    Earliest.clear();
+    BitVector Ant, WBAvail, Val;
+    SmallVector<unsigned, 8> EarliestIds;
+    for (size_t Idx = 0; Idx < Order.size(); ++Idx) {
+        BitVector &BBGen = Gen[Idx], &BBKill = Kill[Idx];
+        BBGen.reset();
+        BBKill.reset();
+        // earliest = anticipated.𝐼𝑁 − will-be-available.𝐼𝑁
+        Ant = AntIn[Idx];
+        WBAvail = WBAvailIn[Idx];
+        Val = Ant;
+        Val.reset(WBAvail);
+        EarliestIds.clear();
+        for (const unsigned Id : Val.set_bits()) {
+            EarliestIds.push_back(Id);
+        }
+        size_t Pos = AntOutBitsBegin[Idx];
+        for (const Instruction &Inst : *Order[Idx]) {
+            if (!EarliestIds.empty()) {
+                Earliest.insert(&Inst, EarliestIds);
+            }
+            const ArrayRef<unsigned> UseIds = InstUseIds.lookup(&Inst),
+                                     DefIds = InstDefIds.lookup(&Inst);
+            // 𝑂𝑈𝑇 = (earliest ∪ 𝐼𝑁) − e_use , composed from the front of the
+            // block
+            for (const unsigned Id : EarliestIds) {
+                BBGen.set(Id);
+                // will-be-available.𝑂𝑈𝑇 = (will-be-available.𝐼𝑁 ∪ earliest)
+                //                          − e_kill
+                WBAvail.set(Id);
+            }
+            for (const unsigned Id : UseIds) {
+                BBGen.reset(Id);
+                BBKill.set(Id);
+            }
+            for (const unsigned Id : DefIds) {
+                WBAvail.reset(Id);
+            }
+            // anticipated.𝑂𝑈𝑇 only differs from anticipated.𝐼𝑁 at the
+            // expressions that the instruction uses or kills, and so does the
+            // earliest placement of the next instruction
+            EarliestIds.clear();
+            for (const unsigned Id : UseIds) {
+                Ant[Id] = AntOutBits[Pos++];
+                EarliestIds.push_back(Id);
+            }
+            for (const unsigned Id : DefIds) {
+                Ant[Id] = AntOutBits[Pos++];
+                EarliestIds.push_back(Id);
+            }
+            llvm::erase_if(EarliestIds, [&](const unsigned Id) {
+                return !Ant.test(Id) || WBAvail.test(Id);
+            });
+            llvm::sort(EarliestIds);
+            EarliestIds.erase(std::unique(EarliestIds.begin(), EarliestIds.end()),
+                              EarliestIds.end());
+        }
+    }
+}
+
+void LCMSolver::initUsed(const Rows_t &PostponableIn) {
+    Latest.clear();
+    BitVector Placeable, SuccPlaceable, Val;
+    SmallVector<unsigned, 8> LatestIds;
+    for (size_t Idx = 0; Idx < Order.size(); ++Idx) {
+        const BasicBlock &BB = *Order[Idx];
+        BitVector &BBGen = Gen[Idx], &BBKill = Kill[Idx];
+        BBGen.reset();
+        BBKill.reset();
+        // earliest ∪ postponable.𝐼𝑁 , i.e., where an expression could be
+        // placed
+        Placeable = PostponableIn[Idx];
+        for (const Instruction &Inst : BB) {
+            for (const unsigned Id : Earliest.lookup(&Inst)) {
+                Placeable.set(Id);
+            }
+            const ArrayRef<unsigned> UseIds = InstUseIds.lookup(&Inst);
+            LatestIds.clear();
+            if (Inst.getNextNode() != nullptr) {
+                // latest = placeable ∩ (e_use ∪ ¬(∩ placeable of the
+                // successors)), where the next instruction can be placed all
+                // that this one can but for its uses
+                for (const unsigned Id : UseIds) {
+                    if (Placeable.test(Id)) {
+                        LatestIds.push_back(Id);
+                    }
+                }
+            } else {
+                // the expressions that can be postponed to all the
+                // successors, none at the exit
+                bool IsFirst = true;
+                for (const BasicBlock *const Succ : successors(&BB)) {
+                    Val = PostponableIn[BBIdxs.at(Succ)];
+                    for (const unsigned Id : Earliest.lookup(&Succ->front())) {
+                        Val.set(Id);
+                    }
+                    if (IsFirst) {
+                        std::swap(SuccPlaceable, Val);
+                        IsFirst = false;
+                    } else {
+                        SuccPlaceable &= Val;
+                    }
+                }
+                if (IsFirst) {
+                    SuccPlaceable.reset();
+                    SuccPlaceable.resize(DomainVector.size());
+                }
+                Val = Placeable;
+                Val.reset(SuccPlaceable);
+                for (const unsigned Id : UseIds) {
+                    if (Placeable.test(Id)) {
+                        Val.set(Id);
+                    }
+                }
+                for (const unsigned Id : Val.set_bits()) {
+                    LatestIds.push_back(Id);
+                }
+            }
+            if (!LatestIds.empty()) {
+                Latest.insert(&Inst, LatestIds);
+            }
+            // used.𝐼𝑁 = (e_use ∪ used.𝑂𝑈𝑇) − latest , composed from the front
+            // of the block
+            for (const unsigned Id : UseIds) {
+                if (!llvm::is_contained(LatestIds, Id) && !BBKill.test(Id)) {
+                    BBGen.set(Id);
+                }
+            }
+            for (const unsigned Id : LatestIds) {
+                BBKill.set(Id);
+            }
+            // postponable.𝑂𝑈𝑇 = placeable − e_use
+            for (const unsigned Id : UseIds) {
+                Placeable.reset(Id);
+            }
+        }
+    }
+}
+
+std::vector<ExprRewrite> LCMSolver::collectRewrites(Function &F,
+                                                    const Rows_t &UsedOut) const {
+    std::vector<ExprRewrite> Rewrites(DomainVector.size());
+    BitVector Used;
+    SmallVector<std::pair<unsigned, Instruction *>, 8> InsertPts;
+    SmallVector<std::pair<unsigned, Instruction *>, 8> Redundant;
+    for (BasicBlock &BB : F) {
+        Used = UsedOut[BBIdxs.at(&BB)];
+        InsertPts.clear();
+        Redundant.clear();
+        for (Instruction &Inst : llvm::reverse(BB)) {
+            const ArrayRef<unsigned> LatestIds = Latest.lookup(&Inst);
+            // placed at the latest and used after
+            for (const unsigned Id : LatestIds) {
+                if (Used.test(Id)) {
+                    InsertPts.emplace_back(Id, &Inst);
+                }
+            }
+            // unless the evaluation is placed at the latest and is the only
+            // use
+            for (const unsigned Id : InstUseIds.lookup(&Inst)) {
+                if (!llvm::is_contained(LatestIds, Id) || Used.test(Id)) {
+                    Redundant.emplace_back(Id, &Inst);
+                }
+                Used.set(Id);
+            }
+            for (const unsigned Id : LatestIds) {
+                Used.reset(Id);
+            }
+        }
+        // (in the order of the instructions)
+        for (const auto &InsertPt : llvm::reverse(InsertPts)) {
+            Rewrites[InsertPt.first].InsertPts.push_back(InsertPt.second);
+        }
+        for (const auto &Eval : llvm::reverse(Redundant)) {
+            Rewrites[Eval.first].Redundant.push_back(Eval.second);
+        }
+    }
+    return Rewrites;
+}
+
+std::vector<ExprRewrite> LCMSolver::run(Function &F) {
+    const bool Timed = TimePassesIsEnabled && Opts.TimePhases;
+    std::vector<ExprRewrite> Rewrites;
+    {
+        NamedRegionTimer SolveTimer("solve", "Solve", "dfa-" + getName(),
+                                    "DFA " + getName(), Timed);
+        initDomain(F);
+        initOrder(F);
+        initAnticipated();
+        solve(/*Forward=*/false, /*Intersect=*/true);
+        {
+            // (the block inputs of (1) are also read by (3))
+            const Rows_t AntIn = std::move(Out);
+            initWBAvail(In);
+            solve(/*Forward=*/true, /*Intersect=*/true);
+            initPostponable(AntIn, In);
+        }
+        AntOutBits = BitVector();
+        solve(/*Forward=*/true, /*Intersect=*/true);
+        initUsed(In);
+        solve(/*Forward=*/false, /*Intersect=*/false);
+        Rewrites = collectRewrites(F, In);
+    }
+    Stats.DomainSize = DomainVector.size();
+    dfa::recordStatistics(getName(), Stats);
+    if (!Opts.StatsReport.empty()) {
+        dfa::appendStatsReport(Opts.StatsReport, getName(), F, Stats);
+    }
+    if (Opts.PrintStats) {
+        LOG_ANALYSIS_INFO << "block visits: " << Stats.BlockVisits;
+    }
+    return Rewrites;
+}
@@ -1,44 +1,211 @@
-#include "DFA.h"
-
-#include <llvm/Passes/PassBuilder.h>
-#include <llvm/Passes/PassPlugin.h>
-
-using namespace llvm;
-
-extern "C" PassPluginLibraryInfo llvmGetPassPluginInfo() {
-  return {
-      .APIVersion = LLVM_PLUGIN_API_VERSION,
-      .PluginName = "DFA",
-      .PluginVersion = LLVM_VERSION_STRING,
-      .RegisterPassBuilderCallbacks =
-          [](PassBuilder &PB) {
-            PB.registerAnalysisRegistrationCallback(
-                [](FunctionAnalysisManager &FAM) {
-                  FAM.registerPass([&]() { return AvailExprs(); });
-                  FAM.registerPass([&]() { return Liveness(); });
-                  FAM.registerPass([&]() { return SCCP(); });
-                });
-            PB.registerPipelineParsingCallback(
-                [](StringRef Name, FunctionPassManager &FPM,
-                   ArrayRef<PassBuilder::PipelineElement>) -> bool {
-                  if (Name == "avail-expr") {
-                    FPM.addPass(AvailExprsWrapperPass());
-                    return true;
-                  }
-                  if (Name == "liveness") {
-                    FPM.addPass(LivenessWrapperPass());
-                    return true;
-                  }
-                  if (Name == "const-prop") {
-                    FPM.addPass(SCCPWrapperPass());
-                    return true;
-                  }
-                  if (Name == "lcm") {
-                    FPM.addPass(LCMWrapperPass());
-                    return true;
-                  }
-                  return false;
-                });
-          } // RegisterPassBuilderCallbacks
-  };        // struct PassPluginLibraryInfo
-}
+#include "DFA.h"
+
+#include <llvm/Passes/PassBuilder.h>
+#include <llvm/Passes/PassPlugin.h>
+
+using namespace llvm;
+
+/// @brief Parse one pipeline parameter of the analyses into @p Opts .
+/// @return False if the parameter is unknown.
+static bool parseDFAParam(StringRef Param, dfa::Options &Opts) {
+  if (Param == "stats") {
+    Opts.PrintStats = true;
+  } else if (Param == "lazy") {
+    Opts.Lazy = true;
+  } else if (Param == "transform") {
+    Opts.Transform = true;
+  } else if (Param == "quiet") {
+    Opts.Output = dfa::OutputMode::Quiet;
+  } else if (Param == "stream") {
+    Opts.Output = dfa::OutputMode::Stream;
+  } else if (Param == "sparse") {
+    Opts.Sparse = true;
+  } else if (Param == "cross-check") {
+    Opts.Sparse = Opts.CrossCheck = true;
+  } else if (Param.consume_front("stats-json=")) {
+    Opts.StatsReport = Param.str();
+    return !Param.empty();
+  } else if (Param.consume_front("cache-dir=")) {
+    Opts.CacheDir = Param.str();
+    return !Param.empty();
+  } else if (Param.consume_front("lazy-cache=")) {
+    Opts.Lazy = true;
+    return !Param.getAsInteger(10, Opts.LazyCacheSize);
+  } else {
+    return false;
+  }
+  return true;
+}
+
+/// @brief Match a pipeline element of the form @c PassName<Param;...> and
+///        parse its parameters into @p Opts .
+/// @return False if @p Name does not refer to @p PassName or one of the
+///         parameters is unknown.
+static bool parseDFAPassName(StringRef Name, const StringRef PassName,
+                             dfa::Options &Opts) {
+  if (!Name.consume_front(PassName)) {
+    return false;
+  }
+  if (Name.empty()) {
+    return true;
+  }
+  if (!Name.consume_front("<") || !Name.consume_back(">")) {
+    return false;
+  }
+  while (!Name.empty()) {
+    StringRef Param;
+    std::tie(Param, Name) = Name.split(';');
+    if (!parseDFAParam(Param, Opts)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/// @brief Parse @c dfa-parallel<Analysis;...;threads=N;Param;...> , where the
+///        remaining parameters apply to all the analyses.
+/// @return False if @p Name is not a valid @c dfa-parallel element.
+static bool parseDFAParallelName(StringRef Name,
+                                 std::vector<std::string> &Analyses,
+                                 dfa::Options &Opts, unsigned &Threads) {
+  if (!Name.consume_front("dfa-parallel<") || !Name.consume_back(">")) {
+    return false;
+  }
+  while (!Name.empty()) {
+    StringRef Param;
+    std::tie(Param, Name) = Name.split(';');
+    if (Param == "avail-expr" || Param == "liveness" || Param == "const-prop") {
+      Analyses.push_back(Param.str());
+    } else if (Param.consume_front("threads=")) {
+      if (Param.getAsInteger(10, Threads)) {
+        return false;
+      }
+    } else if (!parseDFAParam(Param, Opts)) {
+      return false;
+    }
+  }
+  // the functions are only analyzed, never rewritten, in parallel
+  return !Analyses.empty() && !Opts.Transform;
+}
+
+/// @brief Parse @c dfa-interproc<threads=N;Param;...> , where the parameters
+///        apply to the analyses the summaries are solved with.
+/// @return False if @p Name is not a valid @c dfa-interproc element.
+static bool parseDFAInterprocName(StringRef Name, dfa::Options &Opts,
+                                  unsigned &Threads) {
+  if (!Name.consume_front("dfa-interproc")) {
+    return false;
+  }
+  if (Name.empty()) {
+    return true;
+  }
+  if (!Name.consume_front("<") || !Name.consume_back(">")) {
+    return false;
+  }
+  while (!Name.empty()) {
+    StringRef Param;
+    std::tie(Param, Name) = Name.split(';');
+    if (Param.consume_front("threads=")) {
+      if (Param.getAsInteger(10, Threads)) {
+        return false;
+      }
+    } else if (!parseDFAParam(Param, Opts)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/// @brief Parse @c dfa-incremental-bench<Analysis;edits=N;Param;...> , where
+///        the analysis is one of the gen/kill ones.
+/// @return False if @p Name is not a valid @c dfa-incremental-bench element.
+static bool parseDFAIncrementalBenchName(StringRef Name, std::string &Analysis,
+                                         dfa::Options &Opts, unsigned &Edits) {
+  if (!Name.consume_front("dfa-incremental-bench<") || !Name.consume_back(">")) {
+    return false;
+  }
+  while (!Name.empty()) {
+    StringRef Param;
+    std::tie(Param, Name) = Name.split(';');
+    if (Param == "avail-expr" || Param == "liveness") {
+      Analysis = Param.str();
+    } else if (Param.consume_front("edits=")) {
+      if (Param.getAsInteger(10, Edits) || Edits == 0) {
+        return false;
+      }
+    } else if (!parseDFAParam(Param, Opts)) {
+      return false;
+    }
+  }
+  return !Analysis.empty() && !Opts.Transform;
+}
+
+extern "C" PassPluginLibraryInfo llvmGetPassPluginInfo() {
+  return {
+      .APIVersion = LLVM_PLUGIN_API_VERSION,
+      .PluginName = "DFA",
+      .PluginVersion = LLVM_VERSION_STRING,
+      .RegisterPassBuilderCallbacks =
+          [](PassBuilder &PB) {
+            PB.registerAnalysisRegistrationCallback(
+                [](FunctionAnalysisManager &FAM) {
+                  FAM.registerPass([&]() { return AvailExprs(); });
+                  FAM.registerPass([&]() { return Liveness(); });
+                  FAM.registerPass([&]() { return SCCP(); });
+                });
+            PB.registerPipelineParsingCallback(
+                [](StringRef Name, FunctionPassManager &FPM,
+                   ArrayRef<PassBuilder::PipelineElement>) -> bool {
+                  dfa::Options Opts;
+                  if (parseDFAPassName(Name, "avail-expr-cse", Opts)) {
+                    FPM.addPass(AvailExprsCSEPass(Opts));
+                    return true;
+                  }
+                  if (parseDFAPassName(Name, "avail-expr", Opts)) {
+                    FPM.addPass(AvailExprsWrapperPass(Opts));
+                    return true;
+                  }
+                  if (parseDFAPassName(Name, "liveness-adce", Opts)) {
+                    FPM.addPass(LivenessADCEPass(Opts));
+                    return true;
+                  }
+                  if (parseDFAPassName(Name, "liveness", Opts)) {
+                    FPM.addPass(LivenessWrapperPass(Opts));
+                    return true;
+                  }
+                  if (parseDFAPassName(Name, "const-prop", Opts)) {
+                    FPM.addPass(SCCPWrapperPass(Opts));
+                    return true;
+                  }
+                  std::string Analysis;
+                  unsigned Edits = 16;
+                  if (parseDFAIncrementalBenchName(Name, Analysis, Opts, Edits)) {
+                    FPM.addPass(
+                        DFAIncrementalBenchPass(std::move(Analysis), Opts, Edits));
+                    return true;
+                  }
+                  if (parseDFAPassName(Name, "lcm", Opts)) {
+                    FPM.addPass(LCMWrapperPass(Opts));
+                    return true;
+                  }
+                  return false;
+                });
+            PB.registerPipelineParsingCallback(
+                [](StringRef Name, ModulePassManager &MPM,
+                   ArrayRef<PassBuilder::PipelineElement>) -> bool {
+                  std::vector<std::string> Analyses;
+                  dfa::Options Opts;
+                  unsigned Threads = 0;
+                  if (parseDFAParallelName(Name, Analyses, Opts, Threads)) {
+                    MPM.addPass(DFAParallelPass(std::move(Analyses), Opts, Threads));
+                    return true;
+                  }
+                  if (parseDFAInterprocName(Name, Opts, Threads)) {
+                    MPM.addPass(DFAInterprocPass(Opts, Threads));
+                    return true;
+                  }
+                  return false;
+                });
+          } // RegisterPassBuilderCallbacks
+  };        // struct PassPluginLibraryInfo
+}
@@ -1,99 +1,460 @@
-#pragma once // NOLINT(llvm-header-guard)
-
-#include "4-LCM/LCM.h"
-
-#include <DFA/Domain/Expression.h>
-#include <DFA/Domain/Variable.h>
-#include <DFA/Flow/ForwardAnalysis.h>
-#include <DFA/Flow/BackwardAnalysis.h>
-#include <DFA/MeetOp.h>
-
-#include <llvm/IR/PassManager.h>
-
-class AvailExprs final : public dfa::ForwardAnalysis<dfa::Expression, dfa::Bool, dfa::Intersect<dfa::Bool>>,
-                         public llvm::AnalysisInfoMixin<AvailExprs> {
-private:
-    using ForwardAnalysis_t = dfa::ForwardAnalysis<dfa::Expression, dfa::Bool,
-            dfa::Intersect<dfa::Bool>>;
-
-    friend llvm::AnalysisInfoMixin<AvailExprs>;
-    static llvm::AnalysisKey Key;
-
-    std::string getName() const final { return "avail-expr"; }
-
-    bool transferFunc(const llvm::Instruction &, const DomainVal_t &,
-                      DomainVal_t &) final;
-
-public:
-    using Result = typename ForwardAnalysis_t::AnalysisResult_t;
-    using ForwardAnalysis_t::run;
-};
-
-class AvailExprsWrapperPass
-        : public llvm::PassInfoMixin<AvailExprsWrapperPass> {
-public:
-    llvm::PreservedAnalyses run(llvm::Function &F,
-                                llvm::FunctionAnalysisManager &FAM) {
-        FAM.getResult<AvailExprs>(F);
-        return llvm::PreservedAnalyses::all();
-    }
-};
-
-/// @todo(CSCD70) Please complete the main body of the following passes, similar
-///               to the Available Expressions pass above.
-
-class Liveness final : public dfa::BackwardAnalysis<dfa::Variable, dfa::Bool, dfa::Union<dfa::Bool>>,
-                       public llvm::AnalysisInfoMixin<Liveness> {
-private:
-    using BackwardAnalysis_t = dfa::BackwardAnalysis<dfa::Variable, dfa::Bool, dfa::Union<dfa::Bool>>;
-    friend llvm::AnalysisInfoMixin<Liveness>;
-    static llvm::AnalysisKey Key;
-
-    std::string getName() const final { return "liveness"; }
-
-    bool transferFunc(const llvm::Instruction &, const DomainVal_t &,
-                      DomainVal_t &) final;
-
-public:
-    using Result = typename BackwardAnalysis_t::AnalysisResult_t;
-    using BackwardAnalysis_t::run;
-};
-
-class LivenessWrapperPass : public llvm::PassInfoMixin<LivenessWrapperPass> {
-public:
-    llvm::PreservedAnalyses run(llvm::Function &F,
-                                llvm::FunctionAnalysisManager &FAM) {
-
-        /// @todo(CSCD70) Get the result from the main body.
-        FAM.getResult<Liveness>(F);
-        return llvm::PreservedAnalyses::all();
-    }
-};
-
-class SCCP final : public dfa::ForwardAnalysis<dfa::Variable, dfa::Lattice, dfa::Intersect<dfa::Lattice>>,
-                       public llvm::AnalysisInfoMixin<SCCP> {
-private:
-    using ForwardAnalysis_t = dfa::ForwardAnalysis<dfa::Variable, dfa::Lattice, dfa::Intersect<dfa::Lattice>>;
-    friend llvm::AnalysisInfoMixin<SCCP>;
-    static llvm::AnalysisKey Key;
-
-    std::string getName() const final { return "const-prop"; }
-
-    bool transferFunc(const llvm::Instruction &, const DomainVal_t &,
-                      DomainVal_t &) final;
-
-public:
-    using Result = typename ForwardAnalysis_t::AnalysisResult_t;
-    using ForwardAnalysis_t::run;
-};
-
-class SCCPWrapperPass : public llvm::PassInfoMixin<SCCPWrapperPass> {
-public:
-    llvm::PreservedAnalyses run(llvm::Function &F,
-                                llvm::FunctionAnalysisManager &FAM) {
-
-        /// @todo(CSCD70) Get the result from the main body.
-        FAM.getResult<SCCP>(F);
-        return llvm::PreservedAnalyses::all();
-    }
-};
+#pragma once // NOLINT(llvm-header-guard)
+
+// (the domains come first, as the framework looks up their operator<< )
+#include <DFA/Domain/Expression.h>
+#include <DFA/Domain/Variable.h>
+#include <DFA/Flow/ForwardAnalysis.h>
+#include <DFA/Flow/BackwardAnalysis.h>
+#include <DFA/MeetOp.h>
+
+#include "4-LCM/LCM.h"
+
+#include <llvm/ADT/DenseSet.h>
+#include <llvm/ADT/STLFunctionalExtras.h>
+#include <llvm/ADT/SmallPtrSet.h>
+#include <llvm/ADT/SmallVector.h>
+#include <llvm/IR/PassManager.h>
+
+class AvailExprs final : public dfa::ForwardAnalysis<AvailExprs, dfa::Expression, dfa::Bool, dfa::Intersect<dfa::Bool>>,
+                         public llvm::AnalysisInfoMixin<AvailExprs> {
+private:
+    using ForwardAnalysis_t = dfa::ForwardAnalysis<AvailExprs, dfa::Expression,
+            dfa::Bool, dfa::Intersect<dfa::Bool>>;
+
+    friend ForwardAnalysis_t::Framework_t;
+    friend llvm::AnalysisInfoMixin<AvailExprs>;
+    static llvm::AnalysisKey Key;
+
+    std::string getName() const final { return "avail-expr"; }
+
+    DomainVal_t initVal() const { return DomainVal_t(DomainIdMap.size(), true); }
+    /// @brief gen𝐵 ∪ (𝑥 − kill𝐵), compared against the previous output
+    ///        (defined here to be inlined into the solver, which calls it for
+    ///        every instruction).
+    LLVM_ATTRIBUTE_ALWAYS_INLINE bool
+    transferFunc(const llvm::Instruction &Inst, const DomainVal_t &IDV,
+                 DomainVal_t &ODV) {
+        return dfa::applyGenKill(IDV, InstUseIds.lookup(&Inst),
+                                 InstDefIds.lookup(&Inst), ODV, ScratchVal);
+    }
+    bool initGenKill(const llvm::Instruction &, DomainVal_t &,
+                     DomainVal_t &);
+    bool getGenKillIds(const llvm::Instruction &, llvm::ArrayRef<unsigned> &,
+                       llvm::ArrayRef<unsigned> &);
+
+public:
+    using Result = typename ForwardAnalysis_t::AnalysisResult_t;
+    using ForwardAnalysis_t::getValueAt;
+    using ForwardAnalysis_t::run;
+    using ForwardAnalysis_t::setOutputStreams;
+    using ForwardAnalysis_t::solve;
+    using ForwardAnalysis_t::update;
+    using ForwardAnalysis_t::reiterate;
+    using ForwardAnalysis_t::getResult;
+    using ForwardAnalysis_t::getNumBlockVisits;
+    using ForwardAnalysis_t::getNumTransferCalls;
+
+    explicit AvailExprs(const dfa::Options &Opts = dfa::Options())
+            : ForwardAnalysis_t(Opts) {}
+
+    /// @brief Rewrite @p F with the results of @c solve : replace every
+    ///        instruction whose expression is available on entry with the
+    ///        evaluation that dominates it, or with a PHI node of those that
+    ///        reach it, and erase it.
+    /// @return The number of instructions erased.
+    size_t rewrite(llvm::Function &F);
+};
+
+class AvailExprsWrapperPass
+        : public llvm::PassInfoMixin<AvailExprsWrapperPass> {
+private:
+    dfa::Options Opts;
+
+public:
+    explicit AvailExprsWrapperPass(const dfa::Options &Opts = dfa::Options())
+            : Opts(Opts) {}
+
+    llvm::PreservedAnalyses run(llvm::Function &F,
+                                llvm::FunctionAnalysisManager &FAM) {
+        // the options are per pipeline element, hence the analysis is run
+        // directly rather than being queried from the FAM
+        AvailExprs(Opts).run(F, FAM);
+        return llvm::PreservedAnalyses::all();
+    }
+};
+
+/// @brief Eliminate the fully redundant expressions with the available
+///        expressions (see @c AvailExprs::rewrite ), e.g., @c avail-expr-cse ,
+///        and report how many have been erased from each function.
+class AvailExprsCSEPass : public llvm::PassInfoMixin<AvailExprsCSEPass> {
+private:
+    dfa::Options Opts;
+
+    std::string getName() const { return "avail-expr-cse"; }
+    llvm::raw_ostream &errs() const { return llvm::errs(); }
+
+public:
+    explicit AvailExprsCSEPass(const dfa::Options &Opts = dfa::Options())
+            : Opts(Opts) {}
+
+    llvm::PreservedAnalyses run(llvm::Function &F,
+                                llvm::FunctionAnalysisManager &FAM);
+};
+
+/// @todo(CSCD70) Please complete the main body of the following passes, similar
+///               to the Available Expressions pass above.
+
+class Liveness final : public dfa::BackwardAnalysis<Liveness, dfa::Variable, dfa::Bool, dfa::Union<dfa::Bool>>,
+                       public llvm::AnalysisInfoMixin<Liveness> {
+private:
+    using BackwardAnalysis_t = dfa::BackwardAnalysis<Liveness, dfa::Variable, dfa::Bool, dfa::Union<dfa::Bool>>;
+    friend BackwardAnalysis_t::Framework_t;
+    friend llvm::AnalysisInfoMixin<Liveness>;
+    static llvm::AnalysisKey Key;
+
+    std::string getName() const final { return "liveness"; }
+
+    /// Reusable buffer of @c getUseIds .
+    llvm::SmallVector<unsigned, 8> LiveUseIds;
+
+    /// @brief Check whether @p U passes a value to a parameter that the
+    ///        summary of the callee has found dead.
+    bool isDeadArgUse(const llvm::Use &U) const;
+    /// @brief Get the ids of the variables used by @p Inst , but those only
+    ///        passed to dead parameters.
+    llvm::ArrayRef<unsigned> getUseIds(const llvm::Instruction &Inst);
+    /// @brief Union the uses with the live variables but the definitions,
+    ///        compared against the previous output (defined here to be
+    ///        inlined into the solver).
+    LLVM_ATTRIBUTE_ALWAYS_INLINE bool
+    transferFunc(const llvm::Instruction &Inst, const DomainVal_t &IDV,
+                 DomainVal_t &ODV) {
+        return dfa::applyGenKill(IDV, getUseIds(Inst), InstDefIds.lookup(&Inst),
+                                 ODV, ScratchVal);
+    }
+    bool initGenKill(const llvm::Instruction &, DomainVal_t &,
+                     DomainVal_t &);
+    bool getGenKillIds(const llvm::Instruction &, llvm::ArrayRef<unsigned> &,
+                       llvm::ArrayRef<unsigned> &);
+    /// @brief Path exploration: every variable is walked up from each of its
+    ///        uses until its definition.
+    bool solveSparse(const llvm::Function &) final;
+
+public:
+    using Result = typename BackwardAnalysis_t::AnalysisResult_t;
+    using BackwardAnalysis_t::getValueAt;
+    using BackwardAnalysis_t::run;
+    using BackwardAnalysis_t::setOutputStreams;
+    using BackwardAnalysis_t::setSummaries;
+    using BackwardAnalysis_t::solve;
+    using BackwardAnalysis_t::update;
+    using BackwardAnalysis_t::reiterate;
+    using BackwardAnalysis_t::getResult;
+    using BackwardAnalysis_t::getNumBlockVisits;
+    using BackwardAnalysis_t::getNumTransferCalls;
+
+    explicit Liveness(const dfa::Options &Opts = dfa::Options())
+            : BackwardAnalysis_t(Opts) {}
+
+    /// @brief Check whether the value of @p Arg may be needed, i.e., it is
+    ///        live on entry to its function (after @c solve ).
+    bool isLiveOnEntry(const llvm::Argument &Arg);
+};
+
+class LivenessWrapperPass : public llvm::PassInfoMixin<LivenessWrapperPass> {
+private:
+    dfa::Options Opts;
+
+public:
+    explicit LivenessWrapperPass(const dfa::Options &Opts = dfa::Options())
+            : Opts(Opts) {}
+
+    llvm::PreservedAnalyses run(llvm::Function &F,
+                                llvm::FunctionAnalysisManager &FAM) {
+        Liveness(Opts).run(F, FAM);
+        return llvm::PreservedAnalyses::all();
+    }
+};
+
+/// @brief Strong liveness (i.e., the complement of the faint variables): a
+///        variable is only live if it may be needed by an instruction that is
+///        live itself, that is, one that has an effect (e.g., a store, a
+///        call or a return), a branch that live instructions depend on, or
+///        one whose own variable is live. Unlike @c Liveness , the values
+///        that only feed each other (e.g., around a loop) are not live.
+class StrongLiveness final : public dfa::BackwardAnalysis<StrongLiveness, dfa::Variable, dfa::Bool, dfa::Union<dfa::Bool>> {
+private:
+    using BackwardAnalysis_t = dfa::BackwardAnalysis<StrongLiveness, dfa::Variable, dfa::Bool, dfa::Union<dfa::Bool>>;
+    friend BackwardAnalysis_t::Framework_t;
+
+    std::string getName() const final { return "strong-liveness"; }
+
+    /// Branches that are live as the live instructions are control
+    /// dependent on them, and those kept regardless (see
+    /// @c eliminateDeadCode ).
+    llvm::DenseSet<const llvm::Instruction *> LiveTerms;
+
+    /// @brief Check whether @p Inst is live, given the variables live right
+    ///        after it.
+    bool isLive(const llvm::Instruction &Inst, const DomainVal_t &Out) const;
+    /// @brief Only the uses of the live instructions are generated (which
+    ///        makes the transfer function depend on its input, hence the
+    ///        analysis is solved instruction by instruction).
+    bool transferFunc(const llvm::Instruction &, const DomainVal_t &,
+                      DomainVal_t &);
+
+public:
+    /// What @c eliminateDeadCode has removed.
+    struct Removed {
+        size_t Insts = 0, BBs = 0;
+        /// Dead conditional branches made unconditional.
+        size_t Branches = 0;
+    };
+
+    explicit StrongLiveness(const dfa::Options &Opts = dfa::Options())
+            : BackwardAnalysis_t(Opts) {}
+
+    /// @brief Aggressive dead code elimination: solve @p F , alternating with
+    ///        the control dependences of the live instructions until no more
+    ///        branch is found live, then erase every instruction that is not
+    ///        live, make every dead conditional branch jump to its immediate
+    ///        post-dominator, and delete the blocks that are no longer
+    ///        reached.
+    Removed eliminateDeadCode(llvm::Function &F);
+};
+
+/// @brief Eliminate the dead instructions, branches and blocks of each
+///        function with the strong liveness (see
+///        @c StrongLiveness::eliminateDeadCode ), e.g., @c liveness-adce , and
+///        report how many instructions and blocks have been removed.
+class LivenessADCEPass : public llvm::PassInfoMixin<LivenessADCEPass> {
+private:
+    dfa::Options Opts;
+
+    std::string getName() const { return "liveness-adce"; }
+    llvm::raw_ostream &errs() const { return llvm::errs(); }
+
+public:
+    explicit LivenessADCEPass(const dfa::Options &Opts = dfa::Options())
+            : Opts(Opts) {}
+
+    llvm::PreservedAnalyses run(llvm::Function &F,
+                                llvm::FunctionAnalysisManager &FAM);
+};
+
+class SCCP final : public dfa::ForwardAnalysis<SCCP, dfa::Variable, dfa::Lattice, dfa::Intersect<dfa::Lattice>>,
+                       public llvm::AnalysisInfoMixin<SCCP> {
+private:
+    using ForwardAnalysis_t = dfa::ForwardAnalysis<SCCP, dfa::Variable, dfa::Lattice, dfa::Intersect<dfa::Lattice>>;
+    friend ForwardAnalysis_t::Framework_t;
+    friend llvm::AnalysisInfoMixin<SCCP>;
+    static llvm::AnalysisKey Key;
+
+    std::string getName() const final { return "const-prop"; }
+
+    using CFGEdge_t = std::pair<const llvm::BasicBlock *, const llvm::BasicBlock *>;
+
+    /// Lattice cell of each variable of the domain (one per SSA value).
+    std::vector<dfa::Lattice> Cells;
+    llvm::DenseSet<CFGEdge_t> ExecutableEdges;
+    llvm::SmallPtrSet<const llvm::BasicBlock *, 16> ExecutableBBs;
+    /// CFG edges that have been found executable but not yet visited.
+    llvm::SmallVector<CFGEdge_t, 16> FlowWorklist;
+    /// Instructions that use a value whose cell has been lowered.
+    llvm::SmallVector<const llvm::Instruction *, 16> SSAWorklist;
+    /// Executable edges and blocks as found by the dense solve (see
+    /// @c transferFunc ), kept apart from those of the sparse engine.
+    llvm::DenseSet<CFGEdge_t> DenseExecEdges;
+    llvm::SmallPtrSet<const llvm::BasicBlock *, 16> DenseExecBBs;
+
+    using LatticeLookup_t = llvm::function_ref<dfa::Lattice(const llvm::Value *)>;
+
+    static dfa::Options sparseOptions(dfa::Options Opts) {
+        Opts.Sparse = true;
+        return Opts;
+    }
+
+    /// @brief Get the lattice value of the result of @p Call , i.e., the
+    ///        returned value of the callee if it is summarized.
+    dfa::Lattice getCallLattice(const llvm::CallBase &Call) const;
+    /// @brief Get the lattice value of @p Arg on entry, i.e., its summary if
+    ///        the callers are summarized.
+    dfa::Lattice getArgLattice(const llvm::Argument &Arg) const;
+    /// @brief Evaluate @p Inst , neither a PHI node nor a terminator, over the
+    ///        lattice values of its operands given by @p getOperand .
+    dfa::Lattice evalInst(const llvm::Instruction &Inst,
+                          LatticeLookup_t getOperand) const;
+    /// @brief Call @p take on each successor of terminator @p Term that may be
+    ///        taken, given the lattice values of its operands.
+    void forEachTakenSucc(const llvm::Instruction &Term, LatticeLookup_t getOperand,
+                          llvm::function_ref<void(const llvm::BasicBlock *)> take) const;
+    /// @brief Lower the cell of @p Inst to @p Val , and queue its users if it
+    ///        has changed.
+    void updateCell(const llvm::Instruction &Inst, const dfa::Lattice &Val);
+    void markEdgeExecutable(const llvm::BasicBlock *From,
+                            const llvm::BasicBlock *To);
+    /// @brief Evaluate @p Inst over the current cells, lowering its own cell
+    ///        or marking its outgoing edges executable.
+    void visitInst(const llvm::Instruction &Inst);
+    /// @brief Derive the boundary value of @p BB from the cells: a variable
+    ///        holds its cell from its (executable) definition onwards, i.e.,
+    ///        in the blocks it reaches through executable ones. Each
+    ///        instruction of @p BB then sets its own cell, if @p BB is
+    ///        executable.
+    bool deriveBlockVals(const llvm::BasicBlock &BB, DomainVal_t &BV,
+                         InstVals_t *InstVals);
+    /// @brief Write the cells, then the executable blocks as a bit per block
+    ///        in function order.
+    void writeSparseSolution(const llvm::Function &F,
+                             dfa::ResultWriter &Writer) const;
+    bool readSparseSolution(const llvm::Function &F, dfa::ResultReader &Reader,
+                            size_t DomainSize);
+
+    /// @brief Evaluate @p Inst over the input value, tracking the executable
+    ///        edges itself, i.e., solve the same problem densely without the
+    ///        cells, for @c cross-check to compare the cells against.
+    bool transferFunc(const llvm::Instruction &, const DomainVal_t &,
+                      DomainVal_t &);
+    /// @brief Wegman-Zadeck propagation over the SSA and CFG-edge worklists.
+    bool solveSparse(const llvm::Function &) final;
+
+public:
+    using Result = typename ForwardAnalysis_t::AnalysisResult_t;
+    using ForwardAnalysis_t::getValueAt;
+    using ForwardAnalysis_t::run;
+    using ForwardAnalysis_t::setOutputStreams;
+    using ForwardAnalysis_t::setSummaries;
+    using ForwardAnalysis_t::solve;
+    using ForwardAnalysis_t::update;
+    using ForwardAnalysis_t::reiterate;
+    using ForwardAnalysis_t::getResult;
+    using ForwardAnalysis_t::getNumBlockVisits;
+    using ForwardAnalysis_t::getNumTransferCalls;
+
+    /// The analysis is only solved sparsely.
+    explicit SCCP(const dfa::Options &Opts = dfa::Options())
+            : ForwardAnalysis_t(sparseOptions(Opts)) {}
+
+    /// @brief Rewrite @p F with the results of @c run : replace the values
+    ///        with a constant cell, fold the branches that have a single
+    ///        executable successor, and delete the unreachable blocks.
+    /// @return True if @p F has been modified.
+    bool rewrite(llvm::Function &F);
+
+    /// @brief Get the lattice value of operand @p V , i.e., its cell if it is
+    ///        a variable of the domain.
+    dfa::Lattice getLattice(const llvm::Value *V) const;
+    bool isExecutable(const llvm::BasicBlock &BB) const {
+        return ExecutableBBs.count(&BB) != 0;
+    }
+    /// @brief Get the lattice value returned by @p F , i.e., the meet over its
+    ///        executable returns.
+    dfa::Lattice getReturnLattice(const llvm::Function &F) const;
+};
+
+class SCCPWrapperPass : public llvm::PassInfoMixin<SCCPWrapperPass> {
+private:
+    dfa::Options Opts;
+
+public:
+    explicit SCCPWrapperPass(const dfa::Options &Opts = dfa::Options())
+            : Opts(Opts) {}
+
+    llvm::PreservedAnalyses run(llvm::Function &F,
+                                llvm::FunctionAnalysisManager &FAM) {
+        SCCP sccp(Opts);
+        sccp.run(F, FAM);
+        if (Opts.Transform && sccp.rewrite(F)) {
+            return llvm::PreservedAnalyses::none();
+        }
+        return llvm::PreservedAnalyses::all();
+    }
+};
+
+// the solvers are instantiated next to the transfer functions, which they
+// inline (see 1-AvailExprs.cpp, 2-Liveness.cpp and 3-SCCP.cpp)
+extern template class dfa::Framework<
+        AvailExprs, dfa::Expression, dfa::Bool, dfa::Intersect<dfa::Bool>,
+        dfa::ForwardMeetBBConstRange_t, dfa::ForwardDependentBBConstRange_t,
+        dfa::ForwardBBConstRange_t, dfa::ForwardInstConstRange_t>;
+extern template class dfa::ForwardAnalysis<AvailExprs, dfa::Expression, dfa::Bool,
+        dfa::Intersect<dfa::Bool>>;
+extern template class dfa::Framework<
+        Liveness, dfa::Variable, dfa::Bool, dfa::Union<dfa::Bool>,
+        dfa::BackwardMeetBBConstRange_t, dfa::BackwardDependentBBConstRange_t,
+        dfa::BackwardBBConstRange_t, dfa::BackwardInstConstRange_t>;
+extern template class dfa::BackwardAnalysis<Liveness, dfa::Variable, dfa::Bool,
+        dfa::Union<dfa::Bool>>;
+extern template class dfa::Framework<
+        SCCP, dfa::Variable, dfa::Lattice, dfa::Intersect<dfa::Lattice>,
+        dfa::ForwardMeetBBConstRange_t, dfa::ForwardDependentBBConstRange_t,
+        dfa::ForwardBBConstRange_t, dfa::ForwardInstConstRange_t>;
+extern template class dfa::ForwardAnalysis<SCCP, dfa::Variable, dfa::Lattice,
+        dfa::Intersect<dfa::Lattice>>;
+
+/// @brief Run analyses over all the functions of a module in a thread pool,
+///        e.g., @c dfa-parallel<avail-expr;liveness;threads=8> . Every worker
+///        has its own analysis instance, and the output of each (function,
+///        analysis) pair is buffered, then printed in module order, so that it
+///        is identical to that of the function passes run one after another.
+class DFAParallelPass : public llvm::PassInfoMixin<DFAParallelPass> {
+private:
+    std::vector<std::string> Analyses;
+    dfa::Options Opts;
+    /// Number of worker threads, 0 for all the cores.
+    unsigned Threads;
+
+public:
+    DFAParallelPass(std::vector<std::string> Analyses, const dfa::Options &Opts,
+                    const unsigned Threads)
+            : Analyses(std::move(Analyses)), Opts(Opts), Threads(Threads) {}
+
+    llvm::PreservedAnalyses run(llvm::Module &M, llvm::ModuleAnalysisManager &MAM);
+};
+
+/// @brief Compute the summaries of all the functions of a module (see
+///        @c dfa::ModuleSummaries ), e.g., @c dfa-interproc<threads=8> : the
+///        returned values and the live arguments over the call-graph SCCs
+///        bottom-up, then the constant arguments top-down, and the returned
+///        values bottom-up again given the arguments. Each SCC is solved
+///        with SCCP and Liveness until its summaries stop changing, and the
+///        SCCs that do not depend on each other are solved in a thread pool.
+///        The summaries are printed in module order, and with @c transform
+///        every function is rewritten by SCCP given them.
+class DFAInterprocPass : public llvm::PassInfoMixin<DFAInterprocPass> {
+private:
+    dfa::Options Opts;
+    /// Number of worker threads, 0 for all the cores.
+    unsigned Threads;
+
+    std::string getName() const { return "summary"; }
+    llvm::raw_ostream &errs() const { return llvm::errs(); }
+
+public:
+    DFAInterprocPass(const dfa::Options &Opts, const unsigned Threads)
+            : Opts(Opts), Threads(Threads) {}
+
+    llvm::PreservedAnalyses run(llvm::Module &M, llvm::ModuleAnalysisManager &MAM);
+};
+
+/// @brief Measure the incremental updates of a gen/kill analysis, e.g.,
+///        @c dfa-incremental-bench<liveness;edits=32> : binary operators are
+///        inserted next to existing ones and erased again, and after each edit
+///        the updated solution is timed and compared against a full re-solve.
+///        The function is left as it was.
+class DFAIncrementalBenchPass
+        : public llvm::PassInfoMixin<DFAIncrementalBenchPass> {
+private:
+    std::string Analysis;
+    dfa::Options Opts;
+    /// Number of edits (insertions and erasures) per function.
+    unsigned Edits;
+
+public:
+    DFAIncrementalBenchPass(std::string Analysis, const dfa::Options &Opts,
+                            const unsigned Edits)
+            : Analysis(std::move(Analysis)), Opts(Opts), Edits(Edits) {}
+
+    llvm::PreservedAnalyses run(llvm::Function &F,
+                                llvm::FunctionAnalysisManager &FAM);
+};
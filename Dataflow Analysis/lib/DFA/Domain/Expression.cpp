@@ -1,22 +1,92 @@
-#include <DFA/Domain/Expression.h>
-
-using namespace llvm;
-using dfa::Expression;
-
-raw_ostream &operator<<(raw_ostream &Outs, const Expression &Expr) {
-  Outs << "[" << Instruction::getOpcodeName(Expr.Opcode) << " ";
-  Expr.LHS->printAsOperand(Outs, false);
-  Outs << ", ";
-  Expr.RHS->printAsOperand(Outs, false);
-  Outs << "]";
-  return Outs;
-}
-
-void Expression::Initializer::visitBinaryOperator(BinaryOperator &BO) {
-  /// fill the domain with binary expression
-  Expression newExpr = Expression(BO);
-  if (!std::count(DomainVector.begin(), DomainVector.end(),newExpr)) {
-      DomainIdMap[newExpr] = DomainVector.size();
-      DomainVector.push_back(newExpr);
-  }
-}
+#include <DFA/Domain/Expression.h>
+#include "Interner.h"
+
+#include <llvm/Analysis/AliasAnalysis.h>
+#include <llvm/Analysis/ValueTracking.h>
+
+using namespace llvm;
+using dfa::Expression;
+
+raw_ostream &operator<<(raw_ostream &Outs, const Expression &Expr) {
+  Outs << "[" << Instruction::getOpcodeName(Expr.Opcode) << " ";
+  if (Expr.Opcode == Instruction::ICmp || Expr.Opcode == Instruction::FCmp) {
+    Outs << CmpInst::getPredicateName(
+                static_cast<CmpInst::Predicate>(Expr.Predicate))
+         << " ";
+  }
+  // (the types are only printed where the operands do not give them)
+  if (Expr.SourceType != nullptr) {
+    Outs << *Expr.SourceType << ", ";
+  } else if (Expr.Opcode == Instruction::Load) {
+    Outs << *Expr.Type << ", ";
+  }
+  for (size_t Idx = 0; Idx < Expr.Operands.size(); ++Idx) {
+    if (Idx != 0) {
+      Outs << ", ";
+    }
+    Expr.Operands[Idx]->printAsOperand(Outs, false);
+  }
+  if (Instruction::isCast(Expr.Opcode)) {
+    Outs << " to " << *Expr.Type;
+  }
+  Outs << "]";
+  return Outs;
+}
+
+/// @brief Get the predicate of @p Inst if it is a comparison, and zero
+///        otherwise (which is also that of @c fcmp @c false , told apart by
+///        the opcode).
+static unsigned getPredicate(const Instruction &Inst) {
+  if (const auto *const Cmp = dyn_cast<CmpInst>(&Inst)) {
+    return Cmp->getPredicate();
+  }
+  return 0;
+}
+
+/// @brief Get the source element type of @p Inst if it is an address
+///        computation, and null otherwise.
+static const Type *getSourceType(const Instruction &Inst) {
+  if (const auto *const GEP = dyn_cast<GetElementPtrInst>(&Inst)) {
+    return GEP->getSourceElementType();
+  }
+  return nullptr;
+}
+
+Expression::Expression(const Instruction &Inst)
+    : Opcode(Inst.getOpcode()), Predicate(getPredicate(Inst)),
+      Type(Inst.getType()), SourceType(getSourceType(Inst)),
+      Operands(Inst.op_begin(), Inst.op_end()),
+      Commutative(Inst.isCommutative() ||
+                  (isa<CmpInst>(Inst) && cast<CmpInst>(Inst).isCommutative())) {}
+
+bool Expression::isExpression(const Instruction &Inst) {
+  if (const auto *const Load = dyn_cast<LoadInst>(&Inst)) {
+    return Load->isSimple();
+  }
+  return isa<BinaryOperator>(Inst) || isa<CmpInst>(Inst) ||
+         isa<CastInst>(Inst) || isa<GetElementPtrInst>(Inst);
+}
+
+bool Expression::mayBeClobberedBy(const Instruction &Inst) const {
+  if (Opcode != Instruction::Load) {
+    return false;
+  }
+  const auto *const Store = dyn_cast<StoreInst>(&Inst);
+  if (Store == nullptr) {
+    return true;
+  }
+  const Value *const StoreObj = getUnderlyingObject(Store->getPointerOperand()),
+                     *const LoadObj = getUnderlyingObject(Operands.front());
+  return StoreObj == LoadObj || !isIdentifiedObject(StoreObj) ||
+         !isIdentifiedObject(LoadObj);
+}
+
+void Expression::Initializer::visitInstruction(Instruction &I) {
+  if (!isExpression(I)) {
+    return;
+  }
+  /// fill the domain with the expression
+  DomainInterner<Expression> interner(DomainIdMap, DomainVector);
+  const unsigned id = interner.intern(Expression(I));
+  InstUseIds.insert(&I, {id});
+}
@@ -0,0 +1,36 @@
+#pragma once // NOLINT(llvm-header-guard)
+
+#include <DFA/Domain/Base.h>
+
+namespace dfa {
+
+/// @brief Interning table over the domain of a function. Each distinct element
+///        is stored once, in @c DomainVector (which acts as the arena of the
+///        elements), and @c DomainIdMap hashes it to its id. Elements that
+///        compare equal (e.g., commutative expressions with swapped operands)
+///        are interned to the same id, and keep the operand order of their
+///        first occurrence.
+template <typename TDomainElem> class DomainInterner {
+private:
+  using DomainIdMap_t = typename TDomainElem::DomainIdMap_t;
+  using DomainVector_t = typename TDomainElem::DomainVector_t;
+
+  DomainIdMap_t &DomainIdMap;
+  DomainVector_t &DomainVector;
+
+public:
+  DomainInterner(DomainIdMap_t &DomainIdMap, DomainVector_t &DomainVector)
+      : DomainIdMap(DomainIdMap), DomainVector(DomainVector) {}
+
+  /// @brief Get the id of @p Elem , inserting it into the domain if it is not
+  ///        there yet. Amortized O(1).
+  unsigned intern(const TDomainElem &Elem) {
+    auto [ElemIt, Inserted] = DomainIdMap.try_emplace(Elem, DomainVector.size());
+    if (Inserted) {
+      DomainVector.push_back(Elem);
+    }
+    return ElemIt->second;
+  }
+};
+
+} // namespace dfa
@@ -0,0 +1,200 @@
+#include <DFA/Flow/ResultCache.h>
+
+#include <llvm/IR/Instructions.h>
+#include <llvm/Support/MD5.h>
+#include <llvm/Support/Path.h>
+#include <llvm/Support/raw_ostream.h>
+
+#include <atomic>
+
+using namespace llvm;
+using dfa::ResultCache;
+
+// shared by the analyses run in parallel
+static std::atomic<size_t> NumHits{0}, NumMisses{0}, NumBytesMapped{0};
+
+namespace {
+
+/// @brief Hash of the structure of a function, i.e., of what the analyses read
+///        of it: the types, opcodes, flags and operands of its instructions,
+///        the values being numbered in function order, and the attributes of
+///        the function and of its calls (e.g., whether an argument is noalias,
+///        or whether a call may have side effects). The names of the values
+///        and the metadata do not change the results, and are left out.
+class StructuralHasher {
+  MD5 &Hasher;
+  /// Number of each argument, block and instruction, in function order.
+  DenseMap<const Value *, uint64_t> Numbers;
+  /// (the types are only printed once)
+  DenseMap<const Type *, std::string> TypeNames;
+
+  void update(const uint64_t Val) {
+    Hasher.update(ArrayRef<uint8_t>(reinterpret_cast<const uint8_t *>(&Val),
+                                    sizeof(Val)));
+  }
+  void update(const StringRef Str) {
+    update(Str.size());
+    Hasher.update(Str);
+  }
+  void update(const Type *Ty) {
+    auto It = TypeNames.find(Ty);
+    if (It == TypeNames.end()) {
+      std::string Name;
+      raw_string_ostream(Name) << *Ty;
+      It = TypeNames.try_emplace(Ty, std::move(Name)).first;
+    }
+    update(StringRef(It->second));
+  }
+  void update(const AttributeList Attrs) {
+    update(Attrs.getNumAttrSets());
+    for (const unsigned Idx : Attrs.indexes()) {
+      update(StringRef(Attrs.getAsString(Idx)));
+    }
+  }
+  void updateOperand(const Value *V) {
+    update(V->getValueID());
+    auto It = Numbers.find(V);
+    if (It != Numbers.end()) {
+      update(It->second);
+      return;
+    }
+    update(V->getType());
+    if (const auto *CI = dyn_cast<ConstantInt>(V)) {
+      const APInt &Val = CI->getValue();
+      for (unsigned Idx = 0; Idx < Val.getNumWords(); ++Idx) {
+        update(Val.getRawData()[Idx]);
+      }
+    } else if (const auto *GV = dyn_cast<GlobalValue>(V)) {
+      update(GV->getName());
+      if (const auto *Callee = dyn_cast<Function>(GV)) {
+        update(Callee->getAttributes());
+      }
+    } else if (!isa<MetadataAsValue>(V)) {
+      // e.g., constant expressions, which are rare
+      std::string Printed;
+      raw_string_ostream PrintedOuts(Printed);
+      V->printAsOperand(PrintedOuts, false);
+      update(StringRef(PrintedOuts.str()));
+    }
+  }
+
+public:
+  explicit StructuralHasher(MD5 &Hasher) : Hasher(Hasher) {}
+
+  void update(const Function &F) {
+    uint64_t Number = 0;
+    for (const Argument &Arg : F.args()) {
+      Numbers[&Arg] = Number++;
+    }
+    for (const BasicBlock &BB : F) {
+      Numbers[&BB] = Number++;
+      for (const Instruction &I : BB) {
+        Numbers[&I] = Number++;
+      }
+    }
+    update(F.getName());
+    update(F.getFunctionType());
+    update(F.getAttributes());
+    for (const BasicBlock &BB : F) {
+      update(BB.size());
+      for (const Instruction &I : BB) {
+        update(I.getOpcode());
+        update(I.getType());
+        // (e.g., nuw, nsw, exact and inbounds)
+        update(I.getRawSubclassOptionalData());
+        if (const auto *Cmp = dyn_cast<CmpInst>(&I)) {
+          update(Cmp->getPredicate());
+        } else if (const auto *GEP = dyn_cast<GetElementPtrInst>(&I)) {
+          update(GEP->getSourceElementType());
+        } else if (const auto *Alloca = dyn_cast<AllocaInst>(&I)) {
+          update(Alloca->getAllocatedType());
+        } else if (const auto *Load = dyn_cast<LoadInst>(&I)) {
+          update(Load->isVolatile());
+          update(static_cast<uint64_t>(Load->getOrdering()));
+        } else if (const auto *Store = dyn_cast<StoreInst>(&I)) {
+          update(Store->isVolatile());
+          update(static_cast<uint64_t>(Store->getOrdering()));
+        } else if (const auto *Call = dyn_cast<CallBase>(&I)) {
+          update(Call->getFunctionType());
+          update(Call->getAttributes());
+        } else if (const auto *Phi = dyn_cast<PHINode>(&I)) {
+          for (const BasicBlock *Incoming : Phi->blocks()) {
+            update(Numbers.lookup(Incoming));
+          }
+        }
+        update(I.getNumOperands());
+        for (const Value *Op : I.operands()) {
+          updateOperand(Op);
+        }
+      }
+    }
+  }
+};
+
+} // anonymous namespace
+
+std::string ResultCache::getPath(StringRef Dir, StringRef AnalysisName,
+                                 const bool Lazy, const Function &F) {
+  MD5 Hasher;
+  Hasher.update(AnalysisName);
+  Hasher.update(Lazy ? "lazy" : "eager");
+  StructuralHasher(Hasher).update(F);
+  MD5::MD5Result Hash;
+  Hasher.final(Hash);
+
+  SmallString<128> Path(Dir);
+  sys::path::append(Path, AnalysisName + "-" + Hash.digest() + ".dfa");
+  return std::string(Path);
+}
+
+std::unique_ptr<sys::fs::mapped_file_region>
+ResultCache::map(StringRef Path) {
+  Expected<sys::fs::file_t> File = sys::fs::openNativeFileForRead(Path);
+  if (!File) {
+    consumeError(File.takeError());
+    ++NumMisses;
+    return nullptr;
+  }
+  sys::fs::file_status Status;
+  std::error_code EC = sys::fs::status(*File, Status);
+  std::unique_ptr<sys::fs::mapped_file_region> Region;
+  if (!EC && Status.getSize() != 0) {
+    Region = std::make_unique<sys::fs::mapped_file_region>(
+        *File, sys::fs::mapped_file_region::readonly, Status.getSize(), 0, EC);
+  }
+  // the mapping outlives the descriptor
+  sys::fs::closeFile(*File);
+  if (Region == nullptr || EC) {
+    ++NumMisses;
+    return nullptr;
+  }
+  return Region;
+}
+
+void ResultCache::store(StringRef Path, StringRef Bytes) {
+  SmallString<128> TmpPath;
+  int FD = -1;
+  if (sys::fs::createUniqueFile(Path + ".%%%%%%.tmp", FD, TmpPath)) {
+    return;
+  }
+  {
+    raw_fd_ostream Outs(FD, /*shouldClose=*/true);
+    Outs << Bytes;
+  }
+  if (sys::fs::rename(TmpPath, Path)) {
+    sys::fs::remove(TmpPath);
+  }
+}
+
+void ResultCache::count(const bool Hit, const size_t Bytes) {
+  if (Hit) {
+    ++NumHits;
+    NumBytesMapped += Bytes;
+  } else {
+    ++NumMisses;
+  }
+}
+
+ResultCache::Stats ResultCache::getStats() {
+  return {NumHits, NumMisses, NumBytesMapped};
+}
@@ -0,0 +1,93 @@
+#include <DFA/Flow/Statistics.h>
+
+#include <llvm/ADT/Statistic.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/JSON.h>
+#include <llvm/Support/raw_ostream.h>
+
+#include <mutex>
+
+using namespace llvm;
+using dfa::SolverStats;
+
+namespace {
+
+/// Counters of one analysis, grouped under its name. They are tracked even
+/// if LLVM has been built without statistics, as the plugin is usually
+/// loaded into a release build.
+struct AnalysisStatistics {
+  TrackingStatistic Rounds, BlockVisits, TransferCalls, Meets, MaxDomainSize,
+      MaxBytesHeld;
+};
+
+} // anonymous namespace
+
+#define DFA_ANALYSIS_STATISTICS(Name)                                          \
+  {                                                                            \
+    {Name, "NumRounds", "Number of fixpoint rounds"},                          \
+        {Name, "NumBlockVisits", "Number of basic block visits"},              \
+        {Name, "NumTransferCalls", "Number of transfer function calls"},       \
+        {Name, "NumMeets", "Number of meet operations"},                       \
+        {Name, "MaxDomainSize", "Largest domain"},                             \
+        {Name, "MaxBytesHeld",                                                 \
+         "Most bytes held by the boundary and instruction values"},            \
+  }
+
+static AnalysisStatistics AvailExprsStatistics =
+    DFA_ANALYSIS_STATISTICS("avail-expr");
+static AnalysisStatistics LivenessStatistics =
+    DFA_ANALYSIS_STATISTICS("liveness");
+static AnalysisStatistics SCCPStatistics = DFA_ANALYSIS_STATISTICS("const-prop");
+static AnalysisStatistics LCMStatistics = DFA_ANALYSIS_STATISTICS("lcm");
+static AnalysisStatistics OtherStatistics = DFA_ANALYSIS_STATISTICS("dfa");
+
+static AnalysisStatistics &getStatistics(StringRef AnalysisName) {
+  if (AnalysisName == "avail-expr") {
+    return AvailExprsStatistics;
+  }
+  if (AnalysisName == "liveness") {
+    return LivenessStatistics;
+  }
+  if (AnalysisName == "const-prop") {
+    return SCCPStatistics;
+  }
+  if (AnalysisName == "lcm") {
+    return LCMStatistics;
+  }
+  return OtherStatistics;
+}
+
+void dfa::recordStatistics(StringRef AnalysisName, const SolverStats &Stats) {
+  AnalysisStatistics &Statistics = getStatistics(AnalysisName);
+  Statistics.Rounds += Stats.Rounds;
+  Statistics.BlockVisits += Stats.BlockVisits;
+  Statistics.TransferCalls += Stats.TransferCalls;
+  Statistics.Meets += Stats.Meets;
+  Statistics.MaxDomainSize.updateMax(Stats.DomainSize);
+  Statistics.MaxBytesHeld.updateMax(Stats.BytesHeld);
+}
+
+void dfa::appendStatsReport(StringRef Path, StringRef AnalysisName,
+                            const Function &F, const SolverStats &Stats) {
+  // the functions may be analyzed in parallel
+  static std::mutex ReportMutex;
+  const std::lock_guard<std::mutex> Lock(ReportMutex);
+  std::error_code EC;
+  raw_fd_ostream Outs(Path, EC, sys::fs::OF_Append | sys::fs::OF_Text);
+  if (EC) {
+    errs() << "Cannot open " << Path << ": " << EC.message() << "\n";
+    return;
+  }
+  json::OStream JSON(Outs);
+  JSON.object([&]() {
+    JSON.attribute("function", F.getName());
+    JSON.attribute("analysis", AnalysisName);
+    JSON.attribute("rounds", static_cast<int64_t>(Stats.Rounds));
+    JSON.attribute("block_visits", static_cast<int64_t>(Stats.BlockVisits));
+    JSON.attribute("transfer_calls", static_cast<int64_t>(Stats.TransferCalls));
+    JSON.attribute("meets", static_cast<int64_t>(Stats.Meets));
+    JSON.attribute("domain_size", static_cast<int64_t>(Stats.DomainSize));
+    JSON.attribute("bytes_held", static_cast<int64_t>(Stats.BytesHeld));
+  });
+  Outs << "\n";
+}
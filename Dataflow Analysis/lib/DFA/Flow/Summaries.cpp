@@ -0,0 +1,113 @@
+#include <DFA/Flow/Summaries.h>
+
+#include <llvm/Support/raw_ostream.h>
+
+using namespace llvm;
+using dfa::FunctionSummary;
+using dfa::Lattice;
+using dfa::ModuleSummaries;
+
+/// @brief Check whether every call site of @p F is known (see
+///        @c FunctionSummary::KnownCallSites ).
+static bool hasKnownCallSites(const Function &F) {
+  if (!F.hasLocalLinkage()) {
+    return false;
+  }
+  return llvm::all_of(F.uses(), [&F](const Use &U) {
+    const auto *const Call = dyn_cast<CallBase>(U.getUser());
+    return Call != nullptr && Call->isCallee(&U) &&
+           Call->getFunctionType() == F.getFunctionType();
+  });
+}
+
+ModuleSummaries::ModuleSummaries(const Module &M) {
+  for (const Function &F : M) {
+    if (F.isDeclaration()) {
+      continue;
+    }
+    FunctionSummary &Summary = Summaries[&F];
+    Summary.Args.resize(F.arg_size());
+    for (Lattice &Arg : Summary.Args) {
+      Arg.markOverdef();
+    }
+    Summary.Return.markOverdef();
+    Summary.LiveArgs.resize(F.arg_size(), true);
+    Summary.KnownCallSites = hasKnownCallSites(F);
+  }
+}
+
+FunctionSummary *ModuleSummaries::lookup(const Function &F) {
+  const auto It = Summaries.find(&F);
+  return It != Summaries.end() ? &It->second : nullptr;
+}
+
+const FunctionSummary *ModuleSummaries::lookup(const Function &F) const {
+  const auto It = Summaries.find(&F);
+  return It != Summaries.end() ? &It->second : nullptr;
+}
+
+const Function *ModuleSummaries::getSummarizedCallee(const CallBase &Call) const {
+  const Function *const Callee = Call.getCalledFunction();
+  if (Callee == nullptr || !Callee->hasExactDefinition() ||
+      Call.getFunctionType() != Callee->getFunctionType() ||
+      lookup(*Callee) == nullptr) {
+    return nullptr;
+  }
+  return Callee;
+}
+
+Lattice ModuleSummaries::getArg(const Argument &Arg) const {
+  const FunctionSummary *const Summary = lookup(*Arg.getParent());
+  if (Summary != nullptr) {
+    return Summary->Args[Arg.getArgNo()];
+  }
+  Lattice Val;
+  Val.markOverdef();
+  return Val;
+}
+
+Lattice ModuleSummaries::getReturn(const CallBase &Call) const {
+  if (const Function *const Callee = getSummarizedCallee(Call)) {
+    return lookup(*Callee)->Return;
+  }
+  Lattice Val;
+  Val.markOverdef();
+  return Val;
+}
+
+bool ModuleSummaries::isArgLive(const CallBase &Call, const unsigned ArgNo) const {
+  const Function *const Callee = getSummarizedCallee(Call);
+  // (the variadic arguments have no parameter of their own)
+  if (Callee == nullptr || ArgNo >= Callee->arg_size()) {
+    return true;
+  }
+  return lookup(*Callee)->LiveArgs.test(ArgNo);
+}
+
+std::string ModuleSummaries::stringify(const Function &F) const {
+  const FunctionSummary &Summary = *lookup(F);
+  std::string StringBuf;
+  raw_string_ostream Strout(StringBuf);
+  Strout << '@' << F.getName() << '(';
+  for (const Argument &Arg : F.args()) {
+    if (Arg.getArgNo() != 0) {
+      Strout << ", ";
+    }
+    Arg.printAsOperand(Strout);
+    const Lattice &Val = Summary.Args[Arg.getArgNo()];
+    if (Val.isConstant()) {
+      Strout << " = ";
+      Val.Constant.print(Strout, /*isSigned=*/Val.Constant.getBitWidth() > 1);
+    }
+    if (!Summary.LiveArgs.test(Arg.getArgNo())) {
+      Strout << " (dead)";
+    }
+  }
+  Strout << ')';
+  if (Summary.Return.isConstant()) {
+    Strout << " -> ";
+    Summary.Return.Constant.print(
+        Strout, /*isSigned=*/Summary.Return.Constant.getBitWidth() > 1);
+  }
+  return StringBuf;
+}
@@ -0,0 +1,104 @@
+#include <DFA/Transform/Redundancy.h>
+
+#include <llvm/ADT/MapVector.h>
+#include <llvm/ADT/SmallPtrSet.h>
+#include <llvm/ADT/SmallVector.h>
+#include <llvm/IR/Instructions.h>
+#include <llvm/Transforms/Utils/Local.h>
+#include <llvm/Transforms/Utils/SSAUpdater.h>
+
+using namespace llvm;
+
+using Replacements_t = MapVector<Value *, Value *>;
+
+/// @brief Collect into @p Reaching the instructions of @p AvailSet whose
+///        value @p Val may be at run time, through the PHI nodes and the
+///        evaluations that are replaced in turn.
+static void collectReaching(Value *const Val, const Replacements_t &Replacements,
+                            const SmallPtrSetImpl<Instruction *> &AvailSet,
+                            SmallPtrSetImpl<Instruction *> &Reaching) {
+  SmallPtrSet<Value *, 8> Visited;
+  SmallVector<Value *, 8> Worklist{Val};
+  while (!Worklist.empty()) {
+    Value *const Cur = Worklist.pop_back_val();
+    if (!Visited.insert(Cur).second) {
+      continue;
+    }
+    auto *const Inst = dyn_cast<Instruction>(Cur);
+    const auto ReplacementIt = Replacements.find(Cur);
+    if (ReplacementIt != Replacements.end()) {
+      Worklist.push_back(ReplacementIt->second);
+    } else if (Inst != nullptr && AvailSet.count(Inst)) {
+      Reaching.insert(Inst);
+    } else if (auto *const PHI = dyn_cast_or_null<PHINode>(Inst)) {
+      Worklist.append(PHI->incoming_values().begin(),
+                      PHI->incoming_values().end());
+    }
+  }
+}
+
+void dfa::replaceRedundant(ArrayRef<Instruction *> Avail,
+                           ArrayRef<Instruction *> Redundant,
+                           const Twine &Name) {
+  const Instruction &Expr = *Redundant.front();
+  SmallVector<PHINode *, 8> PHIs;
+  SSAUpdater Updater(&PHIs);
+  Updater.Initialize(Expr.getType(), Name.str());
+  for (Instruction *const Eval : Avail) {
+    Updater.AddAvailableValue(Eval->getParent(), Eval);
+  }
+  // the evaluations are only replaced once all the values are found, as
+  // they may be the value at the end of their block
+  Replacements_t Replacements;
+  for (Instruction *const Eval : Redundant) {
+    // an evaluation earlier in the same block comes first, otherwise the
+    // value flows in from the predecessors
+    Value *Val = nullptr;
+    for (Instruction *const Earlier : Avail) {
+      if (Earlier->getParent() == Eval->getParent() &&
+          Earlier->comesBefore(Eval)) {
+        Val = Earlier;
+      }
+    }
+    if (Val == nullptr) {
+      Val = Updater.GetValueInMiddleOfBlock(Eval->getParent());
+    }
+    Replacements[Eval] = Val;
+  }
+  // (the value found may itself be replaced, e.g., the second of two
+  // evaluations in a block)
+  for (auto &[Eval, Val] : Replacements) {
+    for (auto It = Replacements.find(Val); It != Replacements.end();
+         It = Replacements.find(Val)) {
+      Val = It->second;
+    }
+  }
+  // the values that replace an evaluation stand for it from then on, hence
+  // only keep the flags (e.g., nsw) that it also has, and the metadata that
+  // holds for both (e.g., the union of the !range of two loads), while the
+  // others are left alone
+  const SmallPtrSet<Instruction *, 8> AvailSet(Avail.begin(), Avail.end());
+  SmallPtrSet<Instruction *, 4> Reaching;
+  for (const auto &[Eval, Val] : Replacements) {
+    Reaching.clear();
+    collectReaching(Val, Replacements, AvailSet, Reaching);
+    for (Instruction *const Kept : Reaching) {
+      Kept->andIRFlags(Eval);
+      combineMetadataForCSE(Kept, cast<Instruction>(Eval), /*DoesKMove=*/false);
+    }
+  }
+  for (const auto &[Eval, Val] : Replacements) {
+    Eval->replaceAllUsesWith(Val);
+  }
+  for (const auto &[Eval, Val] : Replacements) {
+    cast<Instruction>(Eval)->eraseFromParent();
+  }
+  // the updater may leave PHI nodes with the same value on every edge
+  // (e.g., around a loop the value is computed in front of)
+  for (PHINode *const PHI : PHIs) {
+    if (Value *const Val = PHI->hasConstantValue()) {
+      PHI->replaceAllUsesWith(Val);
+      PHI->eraseFromParent();
+    }
+  }
+}
@@ -0,0 +1,126 @@
+#include "DFA.h"
+
+#include <llvm/IR/Dominators.h>
+#include <llvm/IR/InstrTypes.h>
+
+#include <chrono>
+
+using namespace llvm;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double elapsedUs(const Clock::time_point Start) {
+  return std::chrono::duration<double, std::micro>(Clock::now() - Start)
+      .count();
+}
+
+/// @brief Count the instructions at which the values of @p Inc and @p Full
+///        differ. The domain elements are matched by equality rather than by
+///        id, as the incremental solver appends the new elements to its domain.
+template <typename TAnalysis>
+size_t countMismatches(Function &F, const TAnalysis &Inc,
+                       const TAnalysis &Full) {
+  const auto IncResult = Inc.getResult(), FullResult = Full.getResult();
+  const auto &IncDomain = std::get<1>(IncResult);
+  const auto &FullIdMap = std::get<0>(FullResult);
+  const auto &IncVals = std::get<3>(IncResult),
+             &FullVals = std::get<3>(FullResult);
+  size_t Mismatches = 0;
+  for (const Instruction &I : instructions(F)) {
+    const BitVector &IncVal = IncVals.at(&I), &FullVal = FullVals.at(&I);
+    bool Same = IncVal.count() == FullVal.count();
+    for (const unsigned Id : IncVal.set_bits()) {
+      auto FullIdIt = FullIdMap.find(IncDomain[Id]);
+      if (!Same || FullIdIt == FullIdMap.end() ||
+          !FullVal.test(FullIdIt->second)) {
+        Same = false;
+        break;
+      }
+    }
+    if (!Same) {
+      ++Mismatches;
+    }
+  }
+  return Mismatches;
+}
+
+/// @brief For each of the sampled binary operators of @p F , insert a user of
+///        it into the last block it dominates, then erase that user again,
+///        updating the solution of @c TAnalysis after every edit and checking
+///        it against a fresh one.
+template <typename TAnalysis>
+void benchIncremental(Function &F, const DominatorTree &DT,
+                      const dfa::Options &Opts, const unsigned Edits,
+                      const StringRef Name) {
+  std::vector<BinaryOperator *> BinOps;
+  for (Instruction &I : instructions(F)) {
+    if (auto *BinOp = dyn_cast<BinaryOperator>(&I)) {
+      BinOps.push_back(BinOp);
+    }
+  }
+  if (BinOps.empty()) {
+    return;
+  }
+  TAnalysis Inc(Opts);
+  Inc.solve(F);
+
+  const size_t Stride = std::max<size_t>(1, BinOps.size() / Edits);
+  size_t NumEdits = 0, Mismatches = 0;
+  double FullUs = 0, IncUs = 0;
+  for (size_t Idx = 0; Idx < BinOps.size() && NumEdits < Edits;
+       Idx += Stride, NumEdits += 2) {
+    BinaryOperator *BinOp = BinOps[Idx];
+    BasicBlock *InsertBB = BinOp->getParent();
+    for (BasicBlock &BB : F) {
+      if (DT.dominates(BinOp->getParent(), &BB)) {
+        InsertBB = &BB;
+      }
+    }
+    // a new expression, and uses that extend across blocks
+    Instruction *NewInst =
+        BinaryOperator::Create(BinOp->getOpcode(), BinOp, BinOp->getOperand(0),
+                               "", InsertBB->getTerminator());
+    for (const bool Erase : {false, true}) {
+      BasicBlock *BB = NewInst->getParent();
+      Clock::time_point Start = Clock::now();
+      if (Erase) {
+        NewInst->eraseFromParent();
+        Inc.update(F, {}, {BB});
+      } else {
+        Inc.update(F, {NewInst}, {});
+      }
+      IncUs += elapsedUs(Start);
+
+      TAnalysis Full(Opts);
+      Start = Clock::now();
+      Full.solve(F);
+      FullUs += elapsedUs(Start);
+      Mismatches += countMismatches(F, Inc, Full);
+    }
+  }
+  errs() << "[dfa-incremental-bench] " << Name << " @" << F.getName() << ": "
+         << NumEdits << " edits, full " << format("%.1f", FullUs)
+         << "us, incremental " << format("%.1f", IncUs)
+         << "us, mismatches: " << Mismatches << "\n";
+}
+
+} // anonymous namespace
+
+PreservedAnalyses DFAIncrementalBenchPass::run(Function &F,
+                                               FunctionAnalysisManager &FAM) {
+  // the edits do not change the CFG
+  const DominatorTree &DT = FAM.getResult<DominatorTreeAnalysis>(F);
+  // the updates need the state of the solver, which a cached result lacks,
+  // and the full solves are measured
+  dfa::Options BenchOpts = Opts;
+  BenchOpts.CacheDir.clear();
+  if (Analysis == "avail-expr") {
+    benchIncremental<AvailExprs>(F, DT, BenchOpts, Edits, Analysis);
+  } else {
+    benchIncremental<Liveness>(F, DT, BenchOpts, Edits, Analysis);
+  }
+  // every inserted instruction has been erased again
+  return PreservedAnalyses::all();
+}
@@ -0,0 +1,331 @@
+#include "DFA.h"
+
+#include <DFA/Flow/Summaries.h>
+
+#include <llvm/ADT/SCCIterator.h>
+#include <llvm/Analysis/CallGraph.h>
+#include <llvm/IR/InstIterator.h>
+#include <llvm/Support/ThreadPool.h>
+
+#include <atomic>
+
+using namespace llvm;
+
+namespace {
+
+/// @brief Functions of a call-graph SCC, with the SCCs they call.
+struct CallGraphSCC {
+  std::vector<Function *> Functions;
+  /// Whether the functions call themselves, directly or through each other.
+  bool Recursive = false;
+  /// Indices of the SCCs called from this one (which come first in
+  /// bottom-up order).
+  std::vector<size_t> Callees;
+};
+
+/// @brief What the summaries of an SCC are solved for.
+enum class Phase {
+  /// The returned values and the live arguments, given the callees.
+  BottomUp,
+  /// The arguments, given the callers.
+  TopDown,
+  /// The returned values again, given the arguments and the callees.
+  Refine
+};
+
+/// @brief Lower @p Val to its meet with @p New .
+/// @return Whether @p Val has changed.
+bool lower(dfa::Lattice &Val, const dfa::Lattice &New) {
+  const dfa::Lattice Lowered = Val & New;
+  if (Lowered == Val) {
+    return false;
+  }
+  Val = Lowered;
+  return true;
+}
+
+/// @brief Group the indices of @p Levels by their value, in increasing order.
+std::vector<std::vector<size_t>> groupByLevel(const std::vector<unsigned> &Levels) {
+  std::vector<std::vector<size_t>> Groups;
+  for (size_t Idx = 0; Idx < Levels.size(); ++Idx) {
+    if (Groups.size() <= Levels[Idx]) {
+      Groups.resize(Levels[Idx] + 1);
+    }
+    Groups[Levels[Idx]].push_back(Idx);
+  }
+  return Groups;
+}
+
+/// @brief Collect the SCCs of the functions defined in @p M , bottom-up,
+///        i.e., every SCC after those it calls, and the SCC of each function.
+void collectSCCs(Module &M, CallGraph &CG, std::vector<CallGraphSCC> &SCCs,
+                 std::unordered_map<const Function *, size_t> &SCCIdxs) {
+  // the functions that are only called from those that are never called
+  // cannot be reached from the external node
+  std::vector<CallGraphNode *> Roots{CG.getExternalCallingNode()};
+  for (Function &F : M) {
+    if (!F.isDeclaration()) {
+      Roots.push_back(CG[&F]);
+    }
+  }
+  for (CallGraphNode *const Root : Roots) {
+    if (SCCIdxs.count(Root->getFunction())) {
+      continue;
+    }
+    for (scc_iterator<CallGraphNode *> It = scc_begin(Root); !It.isAtEnd(); ++It) {
+      CallGraphSCC SCC;
+      for (const CallGraphNode *const Node : *It) {
+        Function *const F = Node->getFunction();
+        if (F != nullptr && !F->isDeclaration()) {
+          SCC.Functions.push_back(F);
+        }
+      }
+      // (or it has been reached from an earlier root)
+      if (SCC.Functions.empty() || SCCIdxs.count(SCC.Functions.front())) {
+        continue;
+      }
+      SCC.Recursive = It.hasCycle();
+      for (const Function *const F : SCC.Functions) {
+        SCCIdxs[F] = SCCs.size();
+      }
+      for (const Function *const F : SCC.Functions) {
+        for (const CallGraphNode::CallRecord &Record : *CG[F]) {
+          const Function *const Callee = Record.second->getFunction();
+          const auto CalleeIt = SCCIdxs.find(Callee);
+          if (Callee != nullptr && CalleeIt != SCCIdxs.end() &&
+              CalleeIt->second != SCCs.size()) {
+            SCC.Callees.push_back(CalleeIt->second);
+          }
+        }
+      }
+      llvm::sort(SCC.Callees);
+      SCC.Callees.erase(std::unique(SCC.Callees.begin(), SCC.Callees.end()),
+                        SCC.Callees.end());
+      SCCs.push_back(std::move(SCC));
+    }
+  }
+}
+
+/// @brief Solver of the summaries of one SCC, given those of the SCCs it
+///        depends on. The summaries of an SCC are only written while it is
+///        being solved, hence SCCs that do not depend on each other can be
+///        solved concurrently.
+class SummarySolver {
+private:
+  const dfa::Options &Opts;
+  dfa::ModuleSummaries &Summaries;
+  /// SCC of every defined function.
+  const std::unordered_map<const Function *, size_t> &SCCIdxs;
+  std::atomic<size_t> NumSolves{0};
+
+  /// @brief Solve SCCP over @p F , and record the arguments of its call
+  ///        sites.
+  /// @return The value returned by @p F .
+  dfa::Lattice solveConstants(Function &F) {
+    ++NumSolves;
+    SCCP Analysis(Opts);
+    Analysis.setSummaries(&Summaries);
+    Analysis.solve(F);
+    dfa::FunctionSummary &Summary = *Summaries.lookup(F);
+    Summary.CallSiteArgs.clear();
+    for (const Instruction &Inst : instructions(F)) {
+      const auto *const Call = dyn_cast<CallBase>(&Inst);
+      if (Call == nullptr || !Analysis.isExecutable(*Inst.getParent())) {
+        continue;
+      }
+      const Function *const Callee = Summaries.getSummarizedCallee(*Call);
+      if (Callee == nullptr || !Summaries.lookup(*Callee)->KnownCallSites) {
+        continue;
+      }
+      std::vector<dfa::Lattice> &Args = Summary.CallSiteArgs[Call];
+      for (const Use &Arg : Call->args()) {
+        Args.push_back(Analysis.getLattice(Arg.get()));
+      }
+    }
+    return Analysis.getReturnLattice(F);
+  }
+
+  /// @brief Solve Liveness over @p F , and mark its arguments that are live
+  ///        on entry.
+  /// @return Whether any argument has become live.
+  bool solveLiveArgs(Function &F) {
+    ++NumSolves;
+    Liveness Analysis(Opts);
+    Analysis.setSummaries(&Summaries);
+    Analysis.solve(F);
+    dfa::FunctionSummary &Summary = *Summaries.lookup(F);
+    bool Changed = false;
+    for (const Argument &Arg : F.args()) {
+      if (!Summary.LiveArgs.test(Arg.getArgNo()) && Analysis.isLiveOnEntry(Arg)) {
+        Summary.LiveArgs.set(Arg.getArgNo());
+        Changed = true;
+      }
+    }
+    return Changed;
+  }
+
+  /// @brief Meet the arguments of @p F over its recorded call sites, but
+  ///        those within its own SCC, @p SCCIdx , unless @p Internal .
+  std::vector<dfa::Lattice> meetCallSiteArgs(const Function &F,
+                                             const size_t SCCIdx,
+                                             const bool Internal) const {
+    std::vector<dfa::Lattice> Args(F.arg_size());
+    for (const Use &U : F.uses()) {
+      const auto *const Call = cast<CallBase>(U.getUser());
+      const Function *const Caller = Call->getFunction();
+      if (!Internal && SCCIdxs.at(Caller) == SCCIdx) {
+        continue;
+      }
+      // (the call sites that are never executed are not recorded)
+      const auto &Records = Summaries.lookup(*Caller)->CallSiteArgs;
+      const auto It = Records.find(Call);
+      if (It == Records.end()) {
+        continue;
+      }
+      for (size_t ArgNo = 0; ArgNo < Args.size(); ++ArgNo) {
+        Args[ArgNo] = Args[ArgNo] & It->second[ArgNo];
+      }
+    }
+    return Args;
+  }
+
+public:
+  SummarySolver(const dfa::Options &Opts, dfa::ModuleSummaries &Summaries,
+                const std::unordered_map<const Function *, size_t> &SCCIdxs)
+      : Opts(Opts), Summaries(Summaries), SCCIdxs(SCCIdxs) {}
+
+  size_t getNumSolves() const { return NumSolves; }
+
+  /// @brief Solve the summaries of @p SCC , the @p SCCIdx -th one, for
+  ///        @p P . The values solved for start out optimistic within the SCC,
+  ///        and are lowered until they stop changing.
+  void solveSCC(const CallGraphSCC &SCC, const size_t SCCIdx, const Phase P) {
+    for (const Function *const F : SCC.Functions) {
+      dfa::FunctionSummary &Summary = *Summaries.lookup(*F);
+      if (P != Phase::TopDown) {
+        Summary.Return = dfa::Lattice();
+      }
+      if (P == Phase::BottomUp) {
+        Summary.LiveArgs.reset();
+      } else if (P == Phase::TopDown && Summary.KnownCallSites) {
+        Summary.Args = meetCallSiteArgs(*F, SCCIdx, /*Internal=*/false);
+      }
+    }
+    bool Changed = true;
+    while (Changed) {
+      Changed = false;
+      for (Function *const F : SCC.Functions) {
+        const dfa::Lattice Return = solveConstants(*F);
+        if (P != Phase::TopDown) {
+          Changed |= lower(Summaries.lookup(*F)->Return, Return);
+        }
+        if (P == Phase::BottomUp) {
+          Changed |= solveLiveArgs(*F);
+        }
+      }
+      for (const Function *const F : SCC.Functions) {
+        dfa::FunctionSummary &Summary = *Summaries.lookup(*F);
+        if (P != Phase::TopDown || !Summary.KnownCallSites) {
+          continue;
+        }
+        const std::vector<dfa::Lattice> Args =
+            meetCallSiteArgs(*F, SCCIdx, /*Internal=*/true);
+        for (size_t ArgNo = 0; ArgNo < Args.size(); ++ArgNo) {
+          Changed |= lower(Summary.Args[ArgNo], Args[ArgNo]);
+        }
+      }
+      // the functions do not depend on their own summaries otherwise
+      if (!SCC.Recursive) {
+        break;
+      }
+    }
+    // a function that never returns, or is never called, leaves the others
+    // nothing to go by
+    for (const Function *const F : SCC.Functions) {
+      dfa::FunctionSummary &Summary = *Summaries.lookup(*F);
+      if (Summary.Return.isUndef()) {
+        Summary.Return.markOverdef();
+      }
+      for (dfa::Lattice &Arg : Summary.Args) {
+        if (Arg.isUndef()) {
+          Arg.markOverdef();
+        }
+      }
+    }
+  }
+};
+
+} // anonymous namespace
+
+PreservedAnalyses DFAInterprocPass::run(Module &M, ModuleAnalysisManager &MAM) {
+  CallGraph &CG = MAM.getResult<CallGraphAnalysis>(M);
+  std::vector<CallGraphSCC> SCCs;
+  std::unordered_map<const Function *, size_t> SCCIdxs;
+  collectSCCs(M, CG, SCCs, SCCIdxs);
+
+  // the SCCs of a level only depend on those of the levels before it
+  std::vector<unsigned> BottomUpLevels(SCCs.size()), TopDownLevels(SCCs.size());
+  for (size_t SCCIdx = 0; SCCIdx < SCCs.size(); ++SCCIdx) {
+    for (const size_t Callee : SCCs[SCCIdx].Callees) {
+      BottomUpLevels[SCCIdx] =
+          std::max(BottomUpLevels[SCCIdx], BottomUpLevels[Callee] + 1);
+    }
+  }
+  for (size_t SCCIdx = SCCs.size(); SCCIdx-- > 0;) {
+    for (const size_t Callee : SCCs[SCCIdx].Callees) {
+      TopDownLevels[Callee] =
+          std::max(TopDownLevels[Callee], TopDownLevels[SCCIdx] + 1);
+    }
+  }
+
+  // the analyses are only solved, never printed or timed, by the workers
+  dfa::Options WorkerOpts = Opts;
+  WorkerOpts.Output = dfa::OutputMode::Quiet;
+  WorkerOpts.PrintStats = WorkerOpts.Transform = WorkerOpts.TimePhases = false;
+  WorkerOpts.StatsReport.clear();
+  dfa::ModuleSummaries Summaries(M);
+  SummarySolver Solver(WorkerOpts, Summaries, SCCIdxs);
+  ThreadPool Pool(hardware_concurrency(Threads));
+  const std::vector<std::vector<size_t>> BottomUp = groupByLevel(BottomUpLevels),
+                                         TopDown = groupByLevel(TopDownLevels);
+  // (a function solved top-down only knows the values returned by its
+  // callees bottom-up, hence the returned values are solved again)
+  for (const Phase P : {Phase::BottomUp, Phase::TopDown, Phase::Refine}) {
+    for (const std::vector<size_t> &Level : P == Phase::TopDown ? TopDown : BottomUp) {
+      for (const size_t SCCIdx : Level) {
+        Pool.async([&Solver, &SCCs, SCCIdx, P]() {
+          Solver.solveSCC(SCCs[SCCIdx], SCCIdx, P);
+        });
+      }
+      Pool.wait();
+    }
+  }
+
+  if (Opts.Output == dfa::OutputMode::Dump) {
+    for (const Function &F : M) {
+      if (!F.isDeclaration()) {
+        LOG_ANALYSIS_INFO << Summaries.stringify(F);
+      }
+    }
+  }
+  if (Opts.PrintStats) {
+    LOG_ANALYSIS_INFO << "sccs: " << SCCs.size()
+                      << ", levels: " << BottomUp.size()
+                      << ", function solves: " << Solver.getNumSolves();
+  }
+  if (!Opts.Transform) {
+    return PreservedAnalyses::all();
+  }
+  // the constants are created in the context, hence one function at a time
+  bool Changed = false;
+  for (Function &F : M) {
+    if (F.isDeclaration()) {
+      continue;
+    }
+    SCCP Analysis(WorkerOpts);
+    Analysis.setSummaries(&Summaries);
+    Analysis.solve(F);
+    Changed |= Analysis.rewrite(F);
+  }
+  return Changed ? PreservedAnalyses::none() : PreservedAnalyses::all();
+}
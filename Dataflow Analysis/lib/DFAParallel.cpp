@@ -0,0 +1,61 @@
+#include "DFA.h"
+
+#include <llvm/Support/ThreadPool.h>
+
+using namespace llvm;
+
+/// @brief Run @c TAnalysis over @p F , printing into @p Outs
+///        and @p Errs .
+template <typename TAnalysis>
+static void runAnalysis(Function &F, FunctionAnalysisManager &FAM,
+                        const dfa::Options &Opts, raw_ostream &Outs,
+                        raw_ostream &Errs) {
+  dfa::Options WorkerOpts = Opts;
+  WorkerOpts.TimePhases = false;
+  TAnalysis Analysis(WorkerOpts);
+  Analysis.setOutputStreams(Outs, Errs);
+  Analysis.run(F, FAM);
+}
+
+PreservedAnalyses DFAParallelPass::run(Module &M, ModuleAnalysisManager &MAM) {
+  // the analyses do not query the manager, which is not thread-safe
+  FunctionAnalysisManager &FAM =
+      MAM.getResult<FunctionAnalysisManagerModuleProxy>(M).getManager();
+  std::vector<Function *> Functions;
+  for (Function &F : M) {
+    if (!F.isDeclaration()) {
+      Functions.push_back(&F);
+    }
+  }
+
+  struct Output {
+    std::string Outs, Errs;
+  };
+  // one slot per (function, analysis) pair, in the sequential order
+  std::vector<Output> Outputs(Functions.size() * Analyses.size());
+  ThreadPool Pool(hardware_concurrency(Threads));
+  for (size_t FuncIdx = 0; FuncIdx < Functions.size(); ++FuncIdx) {
+    for (size_t AnalysisIdx = 0; AnalysisIdx < Analyses.size(); ++AnalysisIdx) {
+      Output &Out = Outputs[FuncIdx * Analyses.size() + AnalysisIdx];
+      Function &F = *Functions[FuncIdx];
+      const std::string &Name = Analyses[AnalysisIdx];
+      Pool.async([&Out, &F, &Name, &FAM, this]() {
+        raw_string_ostream Outs(Out.Outs), Errs(Out.Errs);
+        if (Name == "avail-expr") {
+          runAnalysis<AvailExprs>(F, FAM, Opts, Outs, Errs);
+        } else if (Name == "liveness") {
+          runAnalysis<Liveness>(F, FAM, Opts, Outs, Errs);
+        } else {
+          runAnalysis<SCCP>(F, FAM, Opts, Outs, Errs);
+        }
+      });
+    }
+  }
+  Pool.wait();
+
+  for (const Output &Out : Outputs) {
+    llvm::outs() << Out.Outs;
+    llvm::errs() << Out.Errs;
+  }
+  return PreservedAnalyses::all();
+}
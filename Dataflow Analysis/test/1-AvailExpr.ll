@@ -1,69 +1,270 @@
-; RUN: opt -S -load-pass-plugin=%dylibdir/libDFA.so \
-; RUN:     -p=avail-expr %s -o %basename_t 2>%basename_t.log
-; RUN: FileCheck --match-full-lines %s --input-file=%basename_t.log
-
-; int main(int argc, char *argv[]) {
-;   int a, b, c, d, e, f;
-;   a = 50;
-;   b = argc + a;
-;   c = 96;
-;   e = b + c;
-;   if (a < b) {
-;     f = b - a;
-;     e = c * b;
-;   } else {
-;     f = b + a;
-;     e = c * b;
-;   }
-;   b = a - c;
-;   d = b + f;
-;   return 0;
-; }
-; @todo(CSCD70) Please complete the CHECK directives.
-
-
-; CHECK-LABEL: [avail-expr] 	{}
-; CHECK-LABEL: [avail-expr] 	{[add %0, 50], }
-; CHECK-LABEL: [avail-expr] 	{[add %0, 50], [add %3, 96], }
-; CHECK-LABEL: [avail-expr] 	{[add %0, 50], [add %3, 96], }
-; CHECK-LABEL: [avail-expr] 	{[add %0, 50], [add %3, 96], }
-
-; CHECK-LABEL: [avail-expr] 	{[add %0, 50], [add %3, 96], }
-; CHECK-LABEL: [avail-expr] 	{[add %0, 50], [add %3, 96], [sub %3, 50], }
-; CHECK-LABEL: [avail-expr] 	{[add %0, 50], [add %3, 96], [sub %3, 50], [mul 96, %3], }
-; CHECK-LABEL: [avail-expr] 	{[add %0, 50], [add %3, 96], [sub %3, 50], [mul 96, %3], }
-
-; CHECK-LABEL: [avail-expr] 	{[add %0, 50], [add %3, 96], }
-; CHECK-LABEL: [avail-expr] 	{[add %0, 50], [add %3, 96], [add %3, 50], }
-; CHECK-LABEL: [avail-expr] 	{[add %0, 50], [add %3, 96], [mul 96, %3], [add %3, 50], }
-; CHECK-LABEL: [avail-expr] 	{[add %0, 50], [add %3, 96], [mul 96, %3], [add %3, 50], }
-
-; CHECK-LABEL: [avail-expr] 	{[add %0, 50], [add %3, 96], [mul 96, %3], }
-; CHECK-LABEL: [avail-expr] 	{[add %0, 50], [add %3, 96], [mul 96, %3], }
-; CHECK-LABEL: [avail-expr] 	{[add %0, 50], [add %3, 96], [mul 96, %3], [sub 50, 96], }
-; CHECK-LABEL: [avail-expr] 	{[add %0, 50], [add %3, 96], [mul 96, %3], [sub 50, 96], [add %13, %.0], }
-; CHECK-LABEL: [avail-expr] 	{[add %0, 50], [add %3, 96], [mul 96, %3], [sub 50, 96], [add %13, %.0], }
-
-
-define i32 @main(i32 noundef %0, ptr noundef %1) {
-  %3 = add nsw i32 %0, 50
-  %4 = add nsw i32 %3, 96
-  %5 = icmp slt i32 50, %3
-  br i1 %5, label %6, label %9
-
-6:                                                ; preds = %2
-  %7 = sub nsw i32 %3, 50
-  %8 = mul nsw i32 96, %3
-  br label %12
-
-9:                                                ; preds = %2
-  %10 = add nsw i32 %3, 50
-  %11 = mul nsw i32 96, %3
-  br label %12
-
-12:                                               ; preds = %9, %6
-  %.0 = phi i32 [ %7, %6 ], [ %10, %9 ]
-  %13 = sub nsw i32 50, 96
-  %14 = add nsw i32 %13, %.0
-  ret i32 0
-}
+; RUN: opt -S -load-pass-plugin=%dylibdir/libDFA.so \
+; RUN:     -p=avail-expr %s -o %basename_t 2>%basename_t.log
+; RUN: FileCheck --match-full-lines %s --input-file=%basename_t.log
+; RUN: opt -S -load-pass-plugin=%dylibdir/libDFA.so \
+; RUN:     -p='avail-expr<stats>' %s -o %basename_t 2>%basename_t.stats.log
+; RUN: FileCheck --check-prefix=STATS --match-full-lines %s --input-file=%basename_t.stats.log
+; RUN: opt -S -load-pass-plugin=%dylibdir/libDFA.so \
+; RUN:     -p='avail-expr<lazy-cache=2>' %s -o %basename_t 2>%basename_t.lazy.log
+; RUN: FileCheck --match-full-lines %s --input-file=%basename_t.lazy.log
+; RUN: opt -S -load-pass-plugin=%dylibdir/libDFA.so \
+; RUN:     -p='dfa-parallel<avail-expr;threads=2>' %s -o %basename_t 2>%basename_t.parallel.log
+; RUN: FileCheck --match-full-lines %s --input-file=%basename_t.parallel.log
+; RUN: opt -S -load-pass-plugin=%dylibdir/libDFA.so \
+; RUN:     -p='avail-expr<quiet>' %s -o %basename_t >%basename_t.quiet.log 2>&1
+; RUN: FileCheck --check-prefix=QUIET --allow-empty %s --input-file=%basename_t.quiet.log
+; RUN: rm -f %basename_t.json
+; RUN: opt -S -load-pass-plugin=%dylibdir/libDFA.so \
+; RUN:     -p='avail-expr<stats-json=%basename_t.json>' %s -o %basename_t 2>/dev/null
+; RUN: FileCheck --check-prefix=JSON --match-full-lines %s --input-file=%basename_t.json
+; RUN: opt -S -load-pass-plugin=%dylibdir/libDFA.so \
+; RUN:     -p=avail-expr-cse %s -o %basename_t.cse.ll 2>%basename_t.cse.log
+; RUN: FileCheck --check-prefix=CSE-LOG --match-full-lines %s --input-file=%basename_t.cse.log
+; RUN: FileCheck --check-prefix=CSE %s --input-file=%basename_t.cse.ll
+; RUN: %dfa-bench -blocks=256 -depth=2 -irreducible=0.2 -repeat=1 \
+; RUN:     -analyses=avail-expr >%basename_t.allocs.csv
+; RUN: FileCheck --check-prefix=ALLOCS %s --input-file=%basename_t.allocs.csv
+
+; int main(int argc, char *argv[]) {
+;   int a, b, c, d, e, f;
+;   a = 50;
+;   b = argc + a;
+;   c = 96;
+;   e = b + c;
+;   if (a < b) {
+;     f = b - a;
+;     e = c * b;
+;   } else {
+;     f = b + a;
+;     e = c * b;
+;   }
+;   b = a - c;
+;   d = b + f;
+;   return 0;
+; }
+; @todo(CSCD70) Please complete the CHECK directives.
+
+
+; CHECK-LABEL: [avail-expr] 	{}
+; CHECK-LABEL: [avail-expr] 	{[add %0, 50], }
+; CHECK-LABEL: [avail-expr] 	{[add %0, 50], [add %3, 96], }
+; CHECK-LABEL: [avail-expr] 	{[add %0, 50], [add %3, 96], [icmp slt 50, %3], }
+; CHECK-LABEL: [avail-expr] 	{[add %0, 50], [add %3, 96], [icmp slt 50, %3], }
+
+; CHECK-LABEL: [avail-expr] 	{[add %0, 50], [add %3, 96], [icmp slt 50, %3], }
+; CHECK-LABEL: [avail-expr] 	{[add %0, 50], [add %3, 96], [icmp slt 50, %3], [sub %3, 50], }
+; CHECK-LABEL: [avail-expr] 	{[add %0, 50], [add %3, 96], [icmp slt 50, %3], [sub %3, 50], [mul 96, %3], }
+; CHECK-LABEL: [avail-expr] 	{[add %0, 50], [add %3, 96], [icmp slt 50, %3], [sub %3, 50], [mul 96, %3], }
+
+; CHECK-LABEL: [avail-expr] 	{[add %0, 50], [add %3, 96], [icmp slt 50, %3], }
+; CHECK-LABEL: [avail-expr] 	{[add %0, 50], [add %3, 96], [icmp slt 50, %3], [add %3, 50], }
+; CHECK-LABEL: [avail-expr] 	{[add %0, 50], [add %3, 96], [icmp slt 50, %3], [mul 96, %3], [add %3, 50], }
+; CHECK-LABEL: [avail-expr] 	{[add %0, 50], [add %3, 96], [icmp slt 50, %3], [mul 96, %3], [add %3, 50], }
+
+; CHECK-LABEL: [avail-expr] 	{[add %0, 50], [add %3, 96], [icmp slt 50, %3], [mul 96, %3], }
+; CHECK-LABEL: [avail-expr] 	{[add %0, 50], [add %3, 96], [icmp slt 50, %3], [mul 96, %3], }
+; CHECK-LABEL: [avail-expr] 	{[add %0, 50], [add %3, 96], [icmp slt 50, %3], [mul 96, %3], [sub 50, 96], }
+; CHECK-LABEL: [avail-expr] 	{[add %0, 50], [add %3, 96], [icmp slt 50, %3], [mul 96, %3], [sub 50, 96], [add %13, %.0], }
+; CHECK-LABEL: [avail-expr] 	{[add %0, 50], [add %3, 96], [icmp slt 50, %3], [mul 96, %3], [sub 50, 96], [add %13, %.0], }
+
+
+; STATS: [avail-expr] block visits: 4
+; QUIET-NOT: {{.}}
+; JSON: {"function":"main","analysis":"avail-expr","rounds":1,"block_visits":4,"transfer_calls":18,"meets":1,"domain_size":8,"bytes_held":{{[0-9]+}}}
+; ALLOCS: avail-expr,256,{{.*}},0{{$}}
+
+define i32 @main(i32 noundef %0, ptr noundef %1) {
+  %3 = add nsw i32 %0, 50
+  %4 = add nsw i32 %3, 96
+  %5 = icmp slt i32 50, %3
+  br i1 %5, label %6, label %9
+
+6:                                                ; preds = %2
+  %7 = sub nsw i32 %3, 50
+  %8 = mul nsw i32 96, %3
+  br label %12
+
+9:                                                ; preds = %2
+  %10 = add nsw i32 %3, 50
+  %11 = mul nsw i32 96, %3
+  br label %12
+
+12:                                               ; preds = %9, %6
+  %.0 = phi i32 [ %7, %6 ], [ %10, %9 ]
+  %13 = sub nsw i32 50, 96
+  %14 = add nsw i32 %13, %.0
+  ret i32 0
+}
+
+; CSE-LOG: [avail-expr-cse] @main: 0 instructions removed
+; CSE-LOG: [avail-expr-cse] @redundant: 4 instructions removed
+
+; the loop computes none of the expressions of the entry, which are still
+; available after it
+; CHECK: [avail-expr] 	{[add %a, %b], [sub %a, %b], [mul %a, %b], [add %v, %w], [add %s, %t], }
+; CHECK: [avail-expr] 	{[add %a, %b], [sub %a, %b], [mul %a, %b], [add %v, %w], [add %s, %t], [add %i, 1], [icmp slt %i.next, %r], }
+
+; CSE-LABEL: define i32 @redundant(i32 %a, i32 %b, i1 %c) {
+; CSE:         %x = add i32 %a, %b
+; CSE:       then:
+; CSE-NEXT:    %y = mul nsw i32 %a, %b
+; CSE-NEXT:    %u = xor i32 %y, %x
+; CSE-NEXT:    br label %join
+; CSE:       join:
+; CSE-NEXT:    %y.cse = phi i32 [ %y, %then ], [ %z, %else ]
+; CSE-NEXT:    %v = phi i32 [ %u, %then ], [ 0, %else ]
+; CSE-NEXT:    %s = add i32 %v, %y.cse
+; CSE-NEXT:    %r = add i32 %s, %x
+; CSE:       exit:
+; CSE-NEXT:    %f = xor i32 %r, %d
+; CSE-NEXT:    ret i32 %f
+
+define i32 @redundant(i32 %a, i32 %b, i1 %c) {
+entry:
+  %x = add i32 %a, %b
+  %d = sub i32 %a, %b
+  br i1 %c, label %then, label %else
+
+then:
+  %y = mul nsw i32 %a, %b
+  %x1 = add nsw i32 %b, %a
+  %u = xor i32 %y, %x1
+  br label %join
+
+else:
+  %z = mul nsw i32 %a, %b
+  br label %join
+
+join:
+  %v = phi i32 [ %u, %then ], [ 0, %else ]
+  %w = mul nsw i32 %a, %b
+  %s = add i32 %v, %w
+  %t = add i32 %a, %b
+  %r = add i32 %s, %t
+  br label %loop
+
+loop:
+  %i = phi i32 [ 0, %join ], [ %i.next, %loop ]
+  %i.next = add i32 %i, 1
+  %cond = icmp slt i32 %i.next, %r
+  br i1 %cond, label %loop, label %exit
+
+exit:
+  %e = sub i32 %a, %b
+  %f = xor i32 %r, %e
+  ret i32 %f
+}
+
+; CSE-LOG: [avail-expr-cse] @flags: 1 instructions removed
+
+; CSE-LABEL: define i32 @flags(i32 %a, i32 %b, i1 %c) {
+; CSE:       then:
+; CSE-NEXT:    %x = add nsw i32 %a, %b
+; CSE-NEXT:    %u = mul i32 %x, %x
+; CSE:       else:
+; CSE-NEXT:    %y = add i32 %a, %b
+
+; only the evaluations that replace another one lose the flags it does not
+; have, not those of the other paths
+define i32 @flags(i32 %a, i32 %b, i1 %c) {
+entry:
+  br i1 %c, label %then, label %else
+
+then:
+  %x = add nsw i32 %a, %b
+  %x2 = add nsw i32 %a, %b
+  %u = mul i32 %x, %x2
+  br label %join
+
+else:
+  %y = add i32 %a, %b
+  br label %join
+
+join:
+  %r = phi i32 [ %u, %then ], [ %y, %else ]
+  ret i32 %r
+}
+
+; CSE-LOG: [avail-expr-cse] @memory: 4 instructions removed
+
+; CHECK: [avail-expr] 	{[getelementptr i32, %p, %i], [sext %l1 to i64], [icmp eq %s1, %i], [zext %l1 to i64], }
+; CHECK: [avail-expr] 	{[getelementptr i32, %p, %i], [load i32, %g1], [sext %l1 to i64], [icmp eq %s1, %i], [zext %l1 to i64], }
+
+; CSE-LABEL: define i64 @memory(ptr noalias %p, i64 %i) {
+; CSE:         %g1 = getelementptr i32, ptr %p, i64 %i
+; CSE-NEXT:    %l1 = load i32, ptr %g1
+; CSE-NEXT:    %s1 = sext i32 %l1 to i64
+; CSE-NEXT:    %c1 = icmp eq i64 %s1, %i
+; CSE-NEXT:    store i32 %l1, ptr %a
+; CSE-NEXT:    %z = zext i32 %l1 to i64
+; CSE-NEXT:    call void @clobber(ptr %g1)
+; CSE-NEXT:    %l3 = load i32, ptr %g1
+; CSE-NEXT:    %sum = add i32 %l1, %l3
+; CSE-NEXT:    %e = sext i32 %sum to i64
+; CSE-NEXT:    %v = select i1 %c1, i64 %s1, i64 %z
+
+; the address computations, casts, comparisons and loads are expressions too,
+; and a load is only killed by the writes that may change what it reads
+define i64 @memory(ptr noalias %p, i64 %i) {
+entry:
+  %a = alloca i32
+  %g1 = getelementptr inbounds i32, ptr %p, i64 %i
+  %l1 = load i32, ptr %g1
+  %s1 = sext i32 %l1 to i64
+  %c1 = icmp eq i64 %s1, %i
+  store i32 %l1, ptr %a
+  %g2 = getelementptr i32, ptr %p, i64 %i
+  %l2 = load i32, ptr %g1
+  %s2 = sext i32 %l1 to i64
+  %z = zext i32 %l1 to i64
+  %c2 = icmp eq i64 %i, %s1
+  call void @clobber(ptr %g2)
+  %l3 = load i32, ptr %g1
+  %sum = add i32 %l2, %l3
+  %e = sext i32 %sum to i64
+  %v = select i1 %c2, i64 %s2, i64 %z
+  %r = add i64 %v, %e
+  ret i64 %r
+}
+
+declare void @clobber(ptr)
+
+; CSE-LOG: [avail-expr-cse] @metadata: 2 instructions removed
+
+; CSE-LABEL: define i32 @metadata(ptr %p, ptr %q, i1 %c) {
+; CSE:         %l1 = load i32, ptr %p, align 4, !range ![[R:[0-9]+]]
+; CSE-NEXT:    %s = add i32 %l1, %l1
+; CSE:       then:
+; CSE-NEXT:    %m1 = load i32, ptr %q, align 4, !range ![[R]]
+; CSE-NEXT:    %t = add i32 %m1, %m1
+; CSE:       else:
+; CSE-NEXT:    %m3 = load i32, ptr %q, align 4, !range ![[R]], !noundef ![[U:[0-9]+]]
+
+; the loads that are kept merge the metadata of those they replace, while
+; the other loads keep theirs
+define i32 @metadata(ptr %p, ptr %q, i1 %c) {
+entry:
+  %l1 = load i32, ptr %p, align 4, !range !0
+  %l2 = load i32, ptr %p, align 4, !range !1
+  %s = add i32 %l1, %l2
+  br i1 %c, label %then, label %else
+
+then:
+  %m1 = load i32, ptr %q, align 4, !range !0
+  %m2 = load i32, ptr %q, align 4
+  %t = add i32 %m1, %m2
+  br label %join
+
+else:
+  %m3 = load i32, ptr %q, align 4, !range !0, !noundef !2
+  br label %join
+
+join:
+  %u = phi i32 [ %t, %then ], [ %m3, %else ]
+  %r = add i32 %s, %u
+  ret i32 %r
+}
+
+!0 = !{i32 0, i32 10}
+!1 = !{i32 0, i32 20}
+!2 = !{}
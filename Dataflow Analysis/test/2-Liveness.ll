@@ -1,66 +1,162 @@
-; RUN: opt -S -load-pass-plugin=%dylibdir/libDFA.so \
-; RUN:     -p=liveness %s -o %basename_t 2>%basename_t.log
-; RUN: FileCheck --match-full-lines %s --input-file=%basename_t.log
-
-; int sum(int a, int b) {
-;   int res = 1;
-;   for (int i = a; i < b; i++) {
-;     res += i;
-;   }
-;   return res;
-; }
-; @todo(CSCD70) Please complete the CHECK directives.
-
-;CHECK-LABEL:[liveness] 	{i32 %6, i32 %0, i32 %8, i32 %1, }
-;CHECK-LABEL:[liveness] 	{i32 %6, i32 %0, i32 %8, i32 %1, }
-
-;CHECK-LABEL:[liveness] 	{i32 %6, i32 %0, i32 %8, i32 %1, }
-;CHECK-LABEL:[liveness] 	{i32 %0, i32 %8, i32 %1, i32 %.01, }
-;CHECK-LABEL:[liveness] 	{i32 %0, i32 %.0, i32 %1, i32 %.01, }
-;CHECK-LABEL:[liveness] 	{i32 %0, i32 %.0, i32 %1, i1 %4, i32 %.01, }
-;CHECK-LABEL:[liveness] 	{i32 %0, i32 %.0, i32 %1, i32 %.01, }
-
-;CHECK-LABEL:[liveness] 	{i32 %0, i32 %.0, i32 %1, i32 %.01, }
-;CHECK-LABEL:[liveness] 	{i32 %6, i32 %0, i32 %.0, i32 %1, }
-;CHECK-LABEL:[liveness] 	{i32 %6, i32 %0, i32 %.0, i32 %1, }
-
-;CHECK-LABEL:[liveness] 	{i32 %6, i32 %0, i32 %.0, i32 %1, }
-;CHECK-LABEL:[liveness] 	{i32 %6, i32 %0, i32 %8, i32 %1, }
-;CHECK-LABEL:[liveness] 	{i32 %6, i32 %0, i32 %8, i32 %1, }
-
-;CHECK-LABEL:[liveness] 	{i32 %.01, }
-;CHECK-LABEL:[liveness] 	{}
-
-define i32 @sum(i32 noundef %0, i32 noundef %1) {
-  br label %3
-3:
-  %.01 = phi i32 [ 1, %2 ], [ %6, %7 ]
-  %.0 = phi i32 [ %0, %2 ], [ %8, %7 ]
-  %4 = icmp slt i32 %.0, %1
-  br i1 %4, label %5, label %9
-
-5:
-  %6 = add nsw i32 %.01, %.0
-  br label %7
-
-7:
-  %8 = add nsw i32 %.0, 1
-  br label %3
-
-9:
-  ret i32 %.01
-}
-
-
-
-
-
-
-
-
-
-
-
-
-
-
+; RUN: opt -S -load-pass-plugin=%dylibdir/libDFA.so \
+; RUN:     -p=liveness %s -o %basename_t 2>%basename_t.log
+; RUN: FileCheck --match-full-lines %s --input-file=%basename_t.log
+; RUN: opt -S -load-pass-plugin=%dylibdir/libDFA.so \
+; RUN:     -p='liveness<stats>' %s -o %basename_t 2>%basename_t.stats.log
+; RUN: FileCheck --check-prefix=STATS --match-full-lines %s --input-file=%basename_t.stats.log
+; RUN: opt -S -load-pass-plugin=%dylibdir/libDFA.so \
+; RUN:     -p='liveness<lazy>' %s -o %basename_t 2>%basename_t.lazy.log
+; RUN: FileCheck --match-full-lines %s --input-file=%basename_t.lazy.log
+; RUN: opt -S -load-pass-plugin=%dylibdir/libDFA.so \
+; RUN:     -p='liveness<sparse>' %s -o %basename_t 2>%basename_t.sparse.log
+; RUN: FileCheck --match-full-lines %s --input-file=%basename_t.sparse.log
+; RUN: opt -S -load-pass-plugin=%dylibdir/libDFA.so \
+; RUN:     -p='liveness<cross-check>' %s -o %basename_t 2>%basename_t.xcheck.log
+; RUN: FileCheck --match-full-lines %s --input-file=%basename_t.xcheck.log
+; RUN: opt -S -load-pass-plugin=%dylibdir/libDFA.so \
+; RUN:     -p='dfa-incremental-bench<liveness;edits=4>' %s -o %basename_t 2>%basename_t.incr.log
+; RUN: FileCheck --check-prefix=INCR %s --input-file=%basename_t.incr.log
+; RUN: opt -S -load-pass-plugin=%dylibdir/libDFA.so \
+; RUN:     -p=liveness-adce %s -o %basename_t.adce.ll 2>%basename_t.adce.log
+; RUN: FileCheck --check-prefix=ADCE-LOG --match-full-lines %s --input-file=%basename_t.adce.log
+; RUN: FileCheck --check-prefix=ADCE %s --input-file=%basename_t.adce.ll
+; RUN: %dfa-bench -blocks=256 -depth=2 -irreducible=0.2 -repeat=1 \
+; RUN:     -analyses=liveness >%basename_t.allocs.csv
+; RUN: FileCheck --check-prefix=ALLOCS %s --input-file=%basename_t.allocs.csv
+
+; int sum(int a, int b) {
+;   int res = 1;
+;   for (int i = a; i < b; i++) {
+;     res += i;
+;   }
+;   return res;
+; }
+; @todo(CSCD70) Please complete the CHECK directives.
+
+;CHECK-LABEL:[liveness] 	{i32 %6, i32 %0, i32 %8, i32 %1, }
+;CHECK-LABEL:[liveness] 	{i32 %6, i32 %0, i32 %8, i32 %1, }
+
+;CHECK-LABEL:[liveness] 	{i32 %6, i32 %0, i32 %8, i32 %1, }
+;CHECK-LABEL:[liveness] 	{i32 %0, i32 %8, i32 %1, i32 %.01, }
+;CHECK-LABEL:[liveness] 	{i32 %0, i32 %.0, i32 %1, i32 %.01, }
+;CHECK-LABEL:[liveness] 	{i32 %0, i32 %.0, i32 %1, i1 %4, i32 %.01, }
+;CHECK-LABEL:[liveness] 	{i32 %0, i32 %.0, i32 %1, i32 %.01, }
+
+;CHECK-LABEL:[liveness] 	{i32 %0, i32 %.0, i32 %1, i32 %.01, }
+;CHECK-LABEL:[liveness] 	{i32 %6, i32 %0, i32 %.0, i32 %1, }
+;CHECK-LABEL:[liveness] 	{i32 %6, i32 %0, i32 %.0, i32 %1, }
+
+;CHECK-LABEL:[liveness] 	{i32 %6, i32 %0, i32 %.0, i32 %1, }
+;CHECK-LABEL:[liveness] 	{i32 %6, i32 %0, i32 %8, i32 %1, }
+;CHECK-LABEL:[liveness] 	{i32 %6, i32 %0, i32 %8, i32 %1, }
+
+;CHECK-LABEL:[liveness] 	{i32 %.01, }
+;CHECK-LABEL:[liveness] 	{}
+
+; STATS: [liveness] block visits: 8
+; INCR: [dfa-incremental-bench] liveness @sum: 4 edits, {{.*}}, mismatches: 0
+; ALLOCS: liveness,256,{{.*}},0{{$}}
+
+; ADCE-LOG:      [liveness-adce] @sum: 0 instructions and 0 blocks removed
+; ADCE-LOG-NEXT: [liveness-adce] @dead_cycle: 2 instructions and 0 blocks removed
+; ADCE-LOG-NEXT: [liveness-adce] @dead_loop: 5 instructions and 1 blocks removed
+; ADCE-LOG-NEXT: [liveness-adce] @dead_diamond: 3 instructions and 2 blocks removed
+
+; ADCE-LABEL: define i32 @dead_cycle(i32 %n) {
+; ADCE:       loop:
+; ADCE-NEXT:    %i = phi i32 [ 0, %entry ], [ %inc, %loop ]
+; ADCE-NEXT:    %inc = add i32 %i, 1
+; ADCE-NEXT:    %cmp = icmp slt i32 %inc, %n
+; ADCE-NEXT:    br i1 %cmp, label %loop, label %exit
+; ADCE-LABEL: define i32 @dead_loop(i32 %n) #0 {
+; ADCE-NEXT:  entry:
+; ADCE-NEXT:    %a = add i32 %n, 1
+; ADCE-NEXT:    br label %loop
+; ADCE:       loop:
+; ADCE-NEXT:    br label %exit
+; ADCE:       exit:
+; ADCE-NEXT:    ret i32 %a
+; ADCE-LABEL: define void @dead_diamond(ptr %p, i32 %a, i1 %c) {
+; ADCE-NEXT:  entry:
+; ADCE-NEXT:    br label %join
+; ADCE:       join:
+; ADCE-NEXT:    store i32 %a, ptr %p
+; ADCE-NEXT:    ret void
+
+define i32 @sum(i32 noundef %0, i32 noundef %1) {
+  br label %3
+3:
+  %.01 = phi i32 [ 1, %2 ], [ %6, %7 ]
+  %.0 = phi i32 [ %0, %2 ], [ %8, %7 ]
+  %4 = icmp slt i32 %.0, %1
+  br i1 %4, label %5, label %9
+
+5:
+  %6 = add nsw i32 %.01, %.0
+  br label %7
+
+7:
+  %8 = add nsw i32 %.0, 1
+  br label %3
+
+9:
+  ret i32 %.01
+}
+
+; the accumulator only feeds itself, while the loop is kept, as it may not
+; terminate
+define i32 @dead_cycle(i32 %n) {
+entry:
+  br label %loop
+
+loop:
+  %i = phi i32 [ 0, %entry ], [ %inc, %loop ]
+  %acc = phi i32 [ 1, %entry ], [ %mul, %loop ]
+  %mul = mul i32 %acc, %i
+  %inc = add i32 %i, 1
+  %cmp = icmp slt i32 %inc, %n
+  br i1 %cmp, label %loop, label %exit
+
+exit:
+  ret i32 %i
+}
+
+; the loop has no effect, and has to terminate
+define i32 @dead_loop(i32 %n) mustprogress {
+entry:
+  %a = add i32 %n, 1
+  br label %loop
+
+loop:
+  %i = phi i32 [ 0, %entry ], [ %inc, %body ]
+  %sum = phi i32 [ 0, %entry ], [ %add, %body ]
+  %cmp = icmp slt i32 %i, %n
+  br i1 %cmp, label %body, label %exit
+
+body:
+  %add = add i32 %sum, %i
+  %inc = add i32 %i, 1
+  br label %loop
+
+exit:
+  ret i32 %a
+}
+
+; the branch only decides on a dead value
+define void @dead_diamond(ptr %p, i32 %a, i1 %c) {
+entry:
+  br i1 %c, label %then, label %else
+
+then:
+  %x = mul i32 %a, 3
+  br label %join
+
+else:
+  %y = sub i32 %a, 7
+  br label %join
+
+join:
+  %v = phi i32 [ %x, %then ], [ %y, %else ]
+  store i32 %a, ptr %p
+  ret void
+}
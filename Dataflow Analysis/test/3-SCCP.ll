@@ -1,77 +1,123 @@
-; RUN: opt -S -load-pass-plugin=%dylibdir/libDFA.so \
-; RUN:     -p=const-prop %s -o %basename_t 2>%basename_t.log
-; RUN: FileCheck --match-full-lines %s --input-file=%basename_t.log
-
-; int Loop() {
-;   int i = 1, j = 1;
-;   for (int k = 0; k < 100;) {
-;     if (j < 20) {
-;       j = i;
-;       k = k + 1;
-;     } else {
-;       j = k;
-;       k = k + 2;
-;     }
-;   }
-;   return j;
-; }
-; @todo(CSCD70) Please complete the CHECK directives.
-
-;CHECK-LABEL: [const-prop] 	{}
-;CHECK-LABEL: [const-prop] 	{}
-
-;CHECK-LABEL: [const-prop] 	{i32 %.12, i32 %.01, i1 %4, }
-;CHECK-LABEL: [const-prop] 	{i32 %.12, i32 %.01, i1 %4, }
-;CHECK-LABEL: [const-prop] 	{i32 %.12, i32 %.01, i1 %4, }
-;CHECK-LABEL: [const-prop] 	{i32 %.12, i32 %.01, i1 %4, }
-;CHECK-LABEL: [const-prop] 	{i32 %.12, i32 %.01, i1 %4, }
-
-;CHECK-LABEL: [const-prop] 	{i32 %.12, i32 %.01, i1 %4, }
-;CHECK-LABEL: [const-prop] 	{i32 %.12, i32 %.01, i1 %4, }
-;CHECK-LABEL: [const-prop] 	{i32 %.12, i32 %.01, i1 %4, }
-
-;CHECK-LABEL: [const-prop] 	{i32 %.12, i32 %.01, i1 %4, }
-;CHECK-LABEL: [const-prop] 	{i32 %.12, i32 %.01, i1 %4, }
-;CHECK-LABEL: [const-prop] 	{i32 %.12, i32 %.01, i1 %4, }
-
-;CHECK-LABEL: [const-prop] 	{i32 %.12, i32 %.01, i1 %4, }
-;CHECK-LABEL: [const-prop] 	{}
-;CHECK-LABEL: [const-prop] 	{}
-
-;CHECK-LABEL: [const-prop] 	{i32 %.12, i32 %.01, i1 %4, }
-;CHECK-LABEL: [const-prop] 	{i32 %.12, i32 %.01, i1 %4, }
-;CHECK-LABEL: [const-prop] 	{i32 %.12, i32 %.01, i1 %4, }
-;CHECK-LABEL: [const-prop] 	{i32 %.12, i32 %.01, i1 %4, }
-
-;CHECK-LABEL: [const-prop] 	{i32 %.12, i32 %.01, i1 %4, }
-;CHECK-LABEL: [const-prop] 	{i32 %.12, i32 %.01, i1 %4, }
-
-define i32 @Loop() {
-  br label %1
-
-1:                                                ; preds = %9, %0
-  %.01 = phi i32 [ 1, %0 ], [ %.12, %9 ]
-  %.0 = phi i32 [ 0, %0 ], [ %.1, %9 ]
-  %2 = icmp slt i32 %.0, 100
-  br i1 %2, label %3, label %10
-
-3:                                                ; preds = %1
-  %4 = icmp slt i32 %.01, 20
-  br i1 %4, label %5, label %7
-
-5:                                                ; preds = %3
-  %6 = add nsw i32 %.0, 1
-  br label %9
-
-7:                                                ; preds = %3
-  %8 = add nsw i32 %.0, 2
-  br label %9
-
-9:                                                ; preds = %7, %5
-  %.12 = phi i32 [ 1, %5 ], [ %.0, %7 ]
-  %.1 = phi i32 [ %6, %5 ], [ %8, %7 ]
-  br label %1
-
-10:                                               ; preds = %1
-  ret i32 %.01
-}
+; RUN: opt -S -load-pass-plugin=%dylibdir/libDFA.so \
+; RUN:     -p=const-prop %s -o %basename_t 2>%basename_t.log
+; RUN: FileCheck --match-full-lines %s --input-file=%basename_t.log
+; RUN: opt -S -load-pass-plugin=%dylibdir/libDFA.so \
+; RUN:     -p='const-prop<stats>' %s -o %basename_t 2>%basename_t.stats.log
+; RUN: FileCheck --check-prefix=STATS --match-full-lines %s --input-file=%basename_t.stats.log
+; RUN: opt -S -load-pass-plugin=%dylibdir/libDFA.so \
+; RUN:     -p='const-prop<cross-check>' %s -o %basename_t 2>%basename_t.xcheck.log
+; RUN: FileCheck --match-full-lines %s --input-file=%basename_t.xcheck.log
+; RUN: opt -S -load-pass-plugin=%dylibdir/libDFA.so \
+; RUN:     -p='const-prop<stream>' %s -o %basename_t >%basename_t.stream.log
+; RUN: FileCheck --check-prefix=STREAM --match-full-lines %s --input-file=%basename_t.stream.log
+; RUN: rm -rf %basename_t.cache && mkdir -p %basename_t.cache
+; RUN: opt -S -load-pass-plugin=%dylibdir/libDFA.so \
+; RUN:     -p='const-prop<cache-dir=%basename_t.cache>' %s -o %basename_t 2>%basename_t.cold.log
+; RUN: FileCheck --match-full-lines %s --input-file=%basename_t.cold.log
+; RUN: opt -S -load-pass-plugin=%dylibdir/libDFA.so \
+; RUN:     -p='const-prop<cache-dir=%basename_t.cache;stats>' %s -o %basename_t 2>%basename_t.warm.log
+; RUN: FileCheck --match-full-lines %s --input-file=%basename_t.warm.log
+; RUN: FileCheck --check-prefix=CACHE --match-full-lines %s --input-file=%basename_t.warm.log
+; RUN: opt -S -load-pass-plugin=%dylibdir/libDFA.so \
+; RUN:     -p='const-prop<transform>' %s -o %basename_t.transform.ll 2>/dev/null
+; RUN: FileCheck --check-prefix=TRANSFORM %s --input-file=%basename_t.transform.ll
+; RUN: %dfa-bench -blocks=256 -depth=2 -irreducible=0.2 -repeat=1 \
+; RUN:     -analyses=const-prop >%basename_t.allocs.csv
+; RUN: FileCheck --check-prefix=ALLOCS %s --input-file=%basename_t.allocs.csv
+
+; int Loop() {
+;   int i = 1, j = 1;
+;   for (int k = 0; k < 100;) {
+;     if (j < 20) {
+;       j = i;
+;       k = k + 1;
+;     } else {
+;       j = k;
+;       k = k + 2;
+;     }
+;   }
+;   return j;
+; }
+; @todo(CSCD70) Please complete the CHECK directives.
+
+;CHECK-LABEL: [const-prop] 	{}
+;CHECK-LABEL: [const-prop] 	{}
+
+;CHECK-LABEL: [const-prop] 	{i32 %.12, i32 %.01, i1 %4, }
+;CHECK-LABEL: [const-prop] 	{i32 %.12, i32 %.01, i1 %4, }
+;CHECK-LABEL: [const-prop] 	{i32 %.12, i32 %.01, i1 %4, }
+;CHECK-LABEL: [const-prop] 	{i32 %.12, i32 %.01, i1 %4, }
+;CHECK-LABEL: [const-prop] 	{i32 %.12, i32 %.01, i1 %4, }
+
+;CHECK-LABEL: [const-prop] 	{i32 %.12, i32 %.01, i1 %4, }
+;CHECK-LABEL: [const-prop] 	{i32 %.12, i32 %.01, i1 %4, }
+;CHECK-LABEL: [const-prop] 	{i32 %.12, i32 %.01, i1 %4, }
+
+;CHECK-LABEL: [const-prop] 	{i32 %.12, i32 %.01, i1 %4, }
+;CHECK-LABEL: [const-prop] 	{i32 %.12, i32 %.01, i1 %4, }
+;CHECK-LABEL: [const-prop] 	{i32 %.12, i32 %.01, i1 %4, }
+
+;CHECK-LABEL: [const-prop] 	{i32 %.12, i32 %.01, i1 %4, }
+;CHECK-LABEL: [const-prop] 	{}
+;CHECK-LABEL: [const-prop] 	{}
+
+;CHECK-LABEL: [const-prop] 	{i32 %.12, i32 %.01, i1 %4, }
+;CHECK-LABEL: [const-prop] 	{i32 %.12, i32 %.01, i1 %4, }
+;CHECK-LABEL: [const-prop] 	{i32 %.12, i32 %.01, i1 %4, }
+;CHECK-LABEL: [const-prop] 	{i32 %.12, i32 %.01, i1 %4, }
+
+;CHECK-LABEL: [const-prop] 	{i32 %.12, i32 %.01, i1 %4, }
+;CHECK-LABEL: [const-prop] 	{i32 %.12, i32 %.01, i1 %4, }
+
+; STATS: [const-prop] block visits: 6
+; STREAM:      function Loop const-prop 8
+; STREAM-NEXT: domain 0 i32 %.12
+; STREAM:      block 0
+; STREAM-NEXT: inst 0
+; STREAM-NEXT: block 1 0=1 4=1 5=1
+; STREAM:      inst 14 0=1 4=1 5=1
+; STREAM-NEXT: end
+; CACHE: [const-prop] block visits: 0
+; CACHE-NEXT: [const-prop] cache hits: 1, misses: 0, bytes mapped: {{[0-9]+}}
+; ALLOCS: const-prop,256,{{.*}},0{{$}}
+
+; j is always 1, hence the else branch is dead and the return is folded.
+; TRANSFORM-LABEL: define i32 @Loop() {
+; TRANSFORM-NOT:   %.01 = phi
+; TRANSFORM:       %.0 = phi i32 [ 0, %0 ], [ [[K:%[0-9]+]], %{{[0-9]+}} ]
+; TRANSFORM-NEXT:  [[CMP:%[0-9]+]] = icmp slt i32 %.0, 100
+; TRANSFORM-NEXT:  br i1 [[CMP]], label
+; TRANSFORM-NOT:   icmp
+; TRANSFORM:       [[K]] = add nsw i32 %.0, 1
+; TRANSFORM-NOT:   add nsw i32 %.0, 2
+; TRANSFORM:       ret i32 1
+
+define i32 @Loop() {
+  br label %1
+
+1:                                                ; preds = %9, %0
+  %.01 = phi i32 [ 1, %0 ], [ %.12, %9 ]
+  %.0 = phi i32 [ 0, %0 ], [ %.1, %9 ]
+  %2 = icmp slt i32 %.0, 100
+  br i1 %2, label %3, label %10
+
+3:                                                ; preds = %1
+  %4 = icmp slt i32 %.01, 20
+  br i1 %4, label %5, label %7
+
+5:                                                ; preds = %3
+  %6 = add nsw i32 %.0, 1
+  br label %9
+
+7:                                                ; preds = %3
+  %8 = add nsw i32 %.0, 2
+  br label %9
+
+9:                                                ; preds = %7, %5
+  %.12 = phi i32 [ 1, %5 ], [ %.0, %7 ]
+  %.1 = phi i32 [ %6, %5 ], [ %8, %7 ]
+  br label %1
+
+10:                                               ; preds = %1
+  ret i32 %.01
+}
@@ -1,61 +1,272 @@
-; RUN: opt -S -load-pass-plugin=%dylibdir/libDFA.so \
-; RUN:     -p=lcm %s -o %basename_t 2>%basename_t.log
-; @todo(CSCD70): FileCheck --match-full-lines %s --input-file=%basename_t.log
-
-; #include "stdio.h"
-
-; int foo(int a, int b, int c) {
-;   if (a > 5) {
-;     int g = b + c;
-;     printf("%d", g);
-;   } else {
-;     while (b < 5) {
-;       b = b + 1;
-;       int d = b + c;
-;       printf("%d", d);
-;     }
-;   }
-;   int e = b + c;
-;   return e;
-; }
-; @todo(CSCD70) Please complete the CHECK directives. Note that:
-;               - The critical edges have to be broken first.
-;               - The outputs from both the 4 analysis passes and the 2
-;                 placements have to be checked.
-
-
-@.str = private unnamed_addr constant [3 x i8] c"%d\00", align 1
-
-define i32 @foo(i32 noundef %0, i32 noundef %1, i32 noundef %2) #0 {
-  %4 = icmp sgt i32 %0, 5
-  br i1 %4, label %5, label %8
-
-5:                                                ; preds = %3
-  %6 = add nsw i32 %1, %2
-  %7 = call i32 (ptr, ...) @printf(ptr noundef @.str, i32 noundef %6)
-  br label %16
-
-8:                                                ; preds = %3
-  br label %9
-
-9:                                                ; preds = %11, %8
-  %.0 = phi i32 [ %1, %8 ], [ %12, %11 ]
-  %10 = icmp slt i32 %.0, 5
-  br i1 %10, label %11, label %15
-
-11:                                               ; preds = %9
-  %12 = add nsw i32 %.0, 1
-  %13 = add nsw i32 %12, %2
-  %14 = call i32 (ptr, ...) @printf(ptr noundef @.str, i32 noundef %13)
-  br label %9
-
-15:                                               ; preds = %9
-  br label %16
-
-16:                                               ; preds = %15, %5
-  %.1 = phi i32 [ %1, %5 ], [ %.0, %15 ]
-  %17 = add nsw i32 %.1, %2
-  ret i32 %17
-}
-
-declare i32 @printf(ptr noundef, ...) #1
+; RUN: opt -S -load-pass-plugin=%dylibdir/libDFA.so \
+; RUN:     -p=lcm %s -o %basename_t 2>%basename_t.log
+; RUN: FileCheck %s --input-file=%basename_t
+; RUN: FileCheck --check-prefix=LOG --match-full-lines %s --input-file=%basename_t.log
+; RUN: opt -S -load-pass-plugin=%dylibdir/libDFA.so \
+; RUN:     -p='lcm<quiet>' %s -o %basename_t.quiet >%basename_t.quiet.log 2>&1
+; RUN: FileCheck --check-prefix=QUIET --allow-empty %s --input-file=%basename_t.quiet.log
+; RUN: diff %basename_t %basename_t.quiet
+; RUN: opt -S -load-pass-plugin=%dylibdir/libDFA.so \
+; RUN:     -p='lcm<quiet;cross-check>' %s -o %basename_t.cross
+; RUN: diff %basename_t %basename_t.cross
+
+; #include "stdio.h"
+
+; int foo(int a, int b, int c) {
+;   if (a > 5) {
+;     int g = b + c;
+;     printf("%d", g);
+;   } else {
+;     while (b < 5) {
+;       b = b + 1;
+;       int d = b + c;
+;       printf("%d", d);
+;     }
+;   }
+;   int e = b + c;
+;   return e;
+; }
+
+; In SSA form, the b + c after the join reads the PHI node of b, i.e., it is
+; not the same expression as in either branch, hence nothing moves.
+
+; LOG-LABEL: [earliest] 	{[add %1, %2], }
+; LOG-LABEL: [earliest] 	{[add %.0, 1], }
+; LOG-NEXT: [earliest] 	{[add %12, %2], }
+; LOG-LABEL: [earliest] 	{[add %.1, %2], }
+; LOG-LABEL: [latest] 	{[add %1, %2], }
+; LOG-LABEL: [latest] 	{[add %.0, 1], }
+; LOG-NEXT: [latest] 	{[add %12, %2], }
+; LOG-LABEL: [latest] 	{[add %.1, %2], }
+; LOG-NOT: [used-expr] 	{[{{.*}}
+; LOG-LABEL: [anticipated-expr] 	{[add %a, %b], }
+; QUIET-NOT: {{.}}
+
+; CHECK-LABEL: define i32 @foo(
+; CHECK: %6 = add nsw i32 %1, %2
+; CHECK: %12 = add nsw i32 %.0, 1
+; CHECK-NEXT: %13 = add nsw i32 %12, %2
+; CHECK: %17 = add nsw i32 %.1, %2
+; CHECK-NEXT: ret i32 %17
+
+@.str = private unnamed_addr constant [3 x i8] c"%d\00", align 1
+
+define i32 @foo(i32 noundef %0, i32 noundef %1, i32 noundef %2) #0 {
+  %4 = icmp sgt i32 %0, 5
+  br i1 %4, label %5, label %8
+
+5:                                                ; preds = %3
+  %6 = add nsw i32 %1, %2
+  %7 = call i32 (ptr, ...) @printf(ptr noundef @.str, i32 noundef %6)
+  br label %16
+
+8:                                                ; preds = %3
+  br label %9
+
+9:                                                ; preds = %11, %8
+  %.0 = phi i32 [ %1, %8 ], [ %12, %11 ]
+  %10 = icmp slt i32 %.0, 5
+  br i1 %10, label %11, label %15
+
+11:                                               ; preds = %9
+  %12 = add nsw i32 %.0, 1
+  %13 = add nsw i32 %12, %2
+  %14 = call i32 (ptr, ...) @printf(ptr noundef @.str, i32 noundef %13)
+  br label %9
+
+15:                                               ; preds = %9
+  br label %16
+
+16:                                               ; preds = %15, %5
+  %.1 = phi i32 [ %1, %5 ], [ %.0, %15 ]
+  %17 = add nsw i32 %.1, %2
+  ret i32 %17
+}
+
+; int diamond(int a, int b, int c) {
+;   if (c)
+;     use(a + b);
+;   return a + b;
+; }
+
+; a + b is partially redundant at the return: it is computed on the (split)
+; edge that does not compute it, and merged with the one that does.
+
+; CHECK-LABEL: define i32 @diamond(
+; CHECK: br i1 %c, label %then, label %entry.join_crit_edge
+; CHECK: entry.join_crit_edge:
+; CHECK-NEXT: %x.pre = add nsw i32 %a, %b
+; CHECK-NEXT: br label %join
+; CHECK: then:
+; CHECK-NEXT: %x = add nsw i32 %a, %b
+; CHECK: join:
+; CHECK-NEXT: %y.pre-phi = phi i32 [ %x.pre, %entry.join_crit_edge ], [ %x, %then ]
+; CHECK-NEXT: ret i32 %y.pre-phi
+
+define i32 @diamond(i32 %a, i32 %b, i1 %c) {
+entry:
+  br i1 %c, label %then, label %join
+
+then:
+  %x = add nsw i32 %a, %b
+  call void @use(i32 %x)
+  br label %join
+
+join:
+  %y = add nsw i32 %a, %b
+  ret i32 %y
+}
+
+; int invariant(int a, int b, int n) {
+;   int s = 0, i = 0;
+;   do {
+;     s += a * b;
+;   } while (++i < n);
+;   return s;
+; }
+
+; The loop body is executed at least once, hence a * b is hoisted in front of
+; the loop, and the back edge that has been split for it is merged back.
+
+; CHECK-LABEL: define i32 @invariant(
+; CHECK-NEXT: entry:
+; CHECK-NEXT: %m.pre = mul i32 %a, %b
+; CHECK-NEXT: br label %body
+; CHECK: body:
+; CHECK-NOT: mul
+; CHECK: %s.next = add i32 %s, %m.pre
+; CHECK: br i1 %cmp, label %body, label %exit
+
+define i32 @invariant(i32 %a, i32 %b, i32 %n) {
+entry:
+  br label %body
+
+body:
+  %i = phi i32 [ 0, %entry ], [ %i.next, %body ]
+  %s = phi i32 [ 0, %entry ], [ %s.next, %body ]
+  %m = mul i32 %a, %b
+  %s.next = add i32 %s, %m
+  %i.next = add i32 %i, 1
+  %cmp = icmp slt i32 %i.next, %n
+  br i1 %cmp, label %body, label %exit
+
+exit:
+  ret i32 %s.next
+}
+
+; int carried(int a, int b, int n) {
+;   int t = a - b;
+;   for (int i = 0; i < n; i++)
+;     use(a - b);
+;   return a - b;
+; }
+
+; Both the evaluations in the loop and after it are fully redundant with the
+; one in front of the loop.
+
+; CHECK-LABEL: define i32 @carried(
+; CHECK: %t0 = sub i32 %a, %b
+; CHECK: body:
+; CHECK-NOT: sub
+; CHECK: call void @use(i32 %t0)
+; CHECK: exit:
+; CHECK-NEXT: ret i32 %t0
+
+define i32 @carried(i32 %a, i32 %b, i32 %n) {
+entry:
+  %t0 = sub i32 %a, %b
+  %g = icmp sgt i32 %n, 0
+  br i1 %g, label %body, label %exit
+
+body:
+  %i = phi i32 [ 0, %entry ], [ %i.next, %body ]
+  %t = sub i32 %a, %b
+  call void @use(i32 %t)
+  %i.next = add i32 %i, 1
+  %cmp = icmp slt i32 %i.next, %n
+  br i1 %cmp, label %body, label %exit
+
+exit:
+  %r = sub i32 %a, %b
+  ret i32 %r
+}
+
+; int guarded(int a, int b, int n) {
+;   for (int i = 0; i < n; i++) {
+;     use(a * b);
+;     use(a / b);
+;   }
+;   return a / b;
+; }
+
+; a * b is not computed on the path that skips the loop, hence it is not
+; hoisted out of it (which would be speculative). a / b is computed on every
+; path, but a division is never moved, as it could trap before the calls.
+
+; CHECK-LABEL: define i32 @guarded(
+; CHECK: entry:
+; CHECK-NEXT: br label %header
+; CHECK: body:
+; CHECK-NEXT: %m = mul i32 %a, %b
+; CHECK: %d = sdiv i32 %a, %b
+; CHECK: exit:
+; CHECK-NEXT: %q = sdiv i32 %a, %b
+
+define i32 @guarded(i32 %a, i32 %b, i32 %n) {
+entry:
+  br label %header
+
+header:
+  %i = phi i32 [ 0, %entry ], [ %i.next, %body ]
+  %cmp = icmp slt i32 %i, %n
+  br i1 %cmp, label %body, label %exit
+
+body:
+  %m = mul i32 %a, %b
+  call void @use(i32 %m)
+  %d = sdiv i32 %a, %b
+  call void @use(i32 %d)
+  %i.next = add i32 %i, 1
+  br label %header
+
+exit:
+  %q = sdiv i32 %a, %b
+  ret i32 %q
+}
+
+; bool address(long *p, long *q, long i, bool c) {
+;   if (c)
+;     usep(&p[i]);
+;   return &p[i] == q;
+; }
+
+; The address computation is partially redundant like the arithmetic, while
+; the comparison, which the other path does not compute, stays in place.
+
+; CHECK-LABEL: define i1 @address(
+; CHECK: entry.join_crit_edge:
+; CHECK-NEXT: %g.pre = getelementptr inbounds i64, ptr %p, i64 %i
+; CHECK-NEXT: br label %join
+; CHECK: join:
+; CHECK-NEXT: %h.pre-phi = phi ptr [ %g.pre, %entry.join_crit_edge ], [ %g, %then ]
+; CHECK-NEXT: %e = icmp eq ptr %h.pre-phi, %q
+; CHECK-NEXT: ret i1 %e
+
+define i1 @address(ptr %p, ptr %q, i64 %i, i1 %c) {
+entry:
+  br i1 %c, label %then, label %join
+
+then:
+  %g = getelementptr inbounds i64, ptr %p, i64 %i
+  call void @usep(ptr %g)
+  br label %join
+
+join:
+  %h = getelementptr inbounds i64, ptr %p, i64 %i
+  %e = icmp eq ptr %h, %q
+  ret i1 %e
+}
+
+declare i32 @printf(ptr noundef, ...) #1
+declare void @use(i32)
+declare void @usep(ptr)
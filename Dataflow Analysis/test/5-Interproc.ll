@@ -0,0 +1,100 @@
+; RUN: opt -S -load-pass-plugin=%dylibdir/libDFA.so \
+; RUN:     -p=dfa-interproc %s -o %basename_t 2>%basename_t.log
+; RUN: FileCheck --match-full-lines %s --input-file=%basename_t.log
+; RUN: opt -S -load-pass-plugin=%dylibdir/libDFA.so \
+; RUN:     -p='dfa-interproc<threads=1;sparse;stats>' %s -o %basename_t 2>%basename_t.stats.log
+; RUN: FileCheck --match-full-lines %s --input-file=%basename_t.stats.log
+; RUN: FileCheck --check-prefix=STATS --match-full-lines %s --input-file=%basename_t.stats.log
+; RUN: opt -S -load-pass-plugin=%dylibdir/libDFA.so \
+; RUN:     -p='dfa-interproc<transform>' %s -o %basename_t.transform.ll 2>/dev/null
+; RUN: FileCheck --check-prefix=TRANSFORM %s --input-file=%basename_t.transform.ll
+
+; static int Square(int x) { return x * x; }
+; static int Answer() { return 42; }
+; static int Next(int n, int unused) { return n + 1; }
+; static int Relay(int n, int unused) { return Next(n, unused); }
+; static int Fibonacci(int n) {
+;   if (n < 2)
+;     return n;
+;   return Fibonacci(n - 1) + Fibonacci(n - 2);
+; }
+; int main() {
+;   int s = Square(3), a = Answer();
+;   int n = Next(a, s), r = Relay(a, n);
+;   printf("%d\n", s + a + n + r + Fibonacci(10));
+;   return 0;
+; }
+
+; CHECK:      [summary] @Square(i32 %x = 3) -> 9
+; CHECK-NEXT: [summary] @Answer() -> 42
+; CHECK-NEXT: [summary] @Next(i32 %n = 42, i32 %unused (dead)) -> 43
+; CHECK-NEXT: [summary] @Relay(i32 %n = 42, i32 %unused (dead)) -> 43
+; CHECK-NEXT: [summary] @Fibonacci(i32 %n)
+; CHECK-NEXT: [summary] @main() -> 0
+; STATS:      [summary] sccs: 6, levels: 3, function solves: {{[0-9]+}}
+
+; TRANSFORM-LABEL: define internal i32 @Square(i32 %x) {
+; TRANSFORM-NEXT:    ret i32 9
+; TRANSFORM-LABEL: define internal i32 @Relay(i32 %n, i32 %unused) {
+; TRANSFORM-NEXT:    %r = call i32 @Next(i32 42, i32 %unused)
+; TRANSFORM-NEXT:    ret i32 43
+; TRANSFORM-LABEL: define i32 @main() {
+; TRANSFORM:         %f = call i32 @Fibonacci(i32 10)
+; TRANSFORM-NEXT:    %sum = add i32 137, %f
+; TRANSFORM-NEXT:    {{.*}} = call i32 (ptr, ...) @printf(ptr @.str, i32 %sum)
+; TRANSFORM-NEXT:    ret i32 0
+
+@.str = private unnamed_addr constant [4 x i8] c"%d\0A\00"
+
+define internal i32 @Square(i32 %x) {
+  %sq = mul nsw i32 %x, %x
+  ret i32 %sq
+}
+
+define internal i32 @Answer() {
+  ret i32 42
+}
+
+define internal i32 @Next(i32 %n, i32 %unused) {
+  %inc = add nsw i32 %n, 1
+  ret i32 %inc
+}
+
+define internal i32 @Relay(i32 %n, i32 %unused) {
+  %r = call i32 @Next(i32 %n, i32 %unused)
+  ret i32 %r
+}
+
+define internal i32 @Fibonacci(i32 %n) {
+entry:
+  %small = icmp slt i32 %n, 2
+  br i1 %small, label %return, label %recurse
+
+recurse:
+  %n1 = sub nsw i32 %n, 1
+  %f1 = call i32 @Fibonacci(i32 %n1)
+  %n2 = sub nsw i32 %n, 2
+  %f2 = call i32 @Fibonacci(i32 %n2)
+  %add = add nsw i32 %f1, %f2
+  br label %return
+
+return:
+  %ret = phi i32 [ %n, %entry ], [ %add, %recurse ]
+  ret i32 %ret
+}
+
+define i32 @main() {
+  %s = call i32 @Square(i32 3)
+  %a = call i32 @Answer()
+  %n = call i32 @Next(i32 %a, i32 %s)
+  %r = call i32 @Relay(i32 %a, i32 %n)
+  %sa = add nsw i32 %s, %a
+  %san = add nsw i32 %sa, %n
+  %sanr = add nsw i32 %san, %r
+  %f = call i32 @Fibonacci(i32 10)
+  %sum = add i32 %sanr, %f
+  %call = call i32 (ptr, ...) @printf(ptr @.str, i32 %sum)
+  ret i32 0
+}
+
+declare i32 @printf(ptr, ...)